@@ -166,6 +166,9 @@ nt::VehicleJourney* VJ::make() {
     } else {
         vj = mvj->create_discrete_vj(uri_str, nt::RTLevel::Base, vp, route, stop_times, pt_data);
     }
+    for (const auto& shape: shapes_from_prev) {
+        vj->set_shape_from_prev(shape.first, shape.second);
+    }
     // default dataset
     if (!vj->dataset){
         auto it = pt_data.datasets_map.find("default:dataset");
@@ -220,7 +223,7 @@ VJ& VJ::st_shape(const navitia::type::LineString& shape) {
     assert(stop_times.back().stop_point->coord == shape.back());
     assert(stop_times.at(stop_times.size() - 2).stop_point->coord == shape.front());
     auto s = boost::make_shared<navitia::type::LineString>(shape);
-    stop_times.back().shape_from_prev = s;
+    shapes_from_prev.emplace_back(stop_times.size() - 1, s);
     return *this;
 }
 
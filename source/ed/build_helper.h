@@ -66,6 +66,7 @@ struct VJ {
     const uint32_t end_time;
     const uint32_t headway_secs;
     std::vector<nt::StopTime> stop_times;
+    std::vector<std::pair<uint16_t, boost::shared_ptr<nt::LineString>>> shapes_from_prev;
     nt::VehicleJourney* vj = nullptr;
 
     /// Construit un nouveau vehicle journey
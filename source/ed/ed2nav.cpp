@@ -37,6 +37,7 @@ www.navitia.io
 #include "utils/init.h"
 #include "utils/functions.h"
 #include "type/meta_data.h"
+#include "type/memory_report.h"
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/program_options.hpp>
@@ -156,6 +157,7 @@ int main(int argc, char * argv[])
     auto logger = log4cplus::Logger::getInstance("log");
     std::string output, connection_string, region_name, cities_connection_string;
     double min_non_connected_graph_ratio;
+    bool high_compression;
     po::options_description desc("Allowed options");
     desc.add_options()
         ("help,h", "Show this message")
@@ -171,7 +173,9 @@ int main(int argc, char * argv[])
         ("connection-string", po::value<std::string>(&connection_string)->required(),
          "database connection parameters: host=localhost user=navitia dbname=navitia password=navitia")
         ("cities-connection-string", po::value<std::string>(&cities_connection_string)->default_value(""),
-         "cities database connection parameters: host=localhost user=navitia dbname=cities password=navitia");
+         "cities database connection parameters: host=localhost user=navitia dbname=cities password=navitia")
+        ("high-compression", po::bool_switch(&high_compression),
+         "compress with LZ4HC: slower, but smaller output, as fast to load");
 
     po::variables_map vm;
     po::store(po::parse_command_line(argc, argv, desc), vm);
@@ -243,11 +247,12 @@ int main(int argc, char * argv[])
     LOG4CPLUS_INFO(logger, "fare tickets: " << data.fare->fare_map.size());
     LOG4CPLUS_INFO(logger, "fare transitions: " << data.fare->nb_transitions());
     LOG4CPLUS_INFO(logger, "fare od: " << data.fare->od_tickets.size());
+    LOG4CPLUS_INFO(logger, "memory usage:\n" << navitia::type::memory_report(data));
     LOG4CPLUS_INFO(logger, "Begin to save ...");
 
     start = pt::microsec_clock::local_time();
     try {
-        data.save(output);
+        data.save(output, high_compression);
     } catch(const navitia::exception &e) {
         LOG4CPLUS_ERROR(logger, "Unable to save");
         LOG4CPLUS_ERROR(logger, e.what());
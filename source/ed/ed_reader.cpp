@@ -175,7 +175,7 @@ void EdReader::fill_admins_postal_codes(navitia::type::Data& , pqxx::work& work)
     }
 }
 
-void EdReader::fill_admin_stop_areas(navitia::type::Data&, pqxx::work& work) {
+void EdReader::fill_admin_stop_areas(navitia::type::Data& data, pqxx::work& work) {
     std::string request = "SELECT admin_id, stop_area_id from navitia.admin_stop_area";
 
     size_t nb_unknown_admin(0), nb_unknown_stop(0), nb_valid_admin(0);
@@ -201,7 +201,7 @@ void EdReader::fill_admin_stop_areas(navitia::type::Data&, pqxx::work& work) {
 
         navitia::type::StopArea* sa = it_sa->second;
 
-        admin->main_stop_areas.push_back(sa);
+        data.pt_data->admin_main_stop_areas[admin->idx].push_back(sa);
         nb_valid_admin++;
     }
     LOG4CPLUS_INFO(log, nb_valid_admin << " admin with at least one main stop");
@@ -837,6 +837,9 @@ void EdReader::fill_vehicle_journeys(nt::Data& data, pqxx::work& work){
                                          std::move(sts_from_vj[vj_id]),
                                          *data.pt_data);
         }
+        for (const auto& shape: shapes_from_vj[vj_id]) {
+            vj->set_shape_from_prev(shape.first, shape.second);
+        }
         const_it["name"].to(vj->name);
         const_it["odt_message"].to(vj->odt_message);
         // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
@@ -915,6 +918,7 @@ void EdReader::fill_vehicle_journeys(nt::Data& data, pqxx::work& work){
         vjid_vj.second->next_vj = vehicle_journey_map[vjid_vj.first];
     }
     release(sts_from_vj);
+    release(shapes_from_vj);
 }
 
 void EdReader::fill_associated_calendar(nt::Data& data, pqxx::work& work) {
@@ -1078,7 +1082,8 @@ void EdReader::fill_stop_times(nt::Data&, pqxx::work& work) {
             stop.stop_point = stop_point_map[const_it[stop_point_id_c].as<idx_t>()];
 
             if(!const_it[shape_from_prev_id_c].is_null()){
-                stop.shape_from_prev = this->shapes_map[const_it[shape_from_prev_id_c].as<idx_t>()];
+                shapes_from_vj[vj_id].emplace_back(order,
+                                                   this->shapes_map[const_it[shape_from_prev_id_c].as<idx_t>()]);
             }
 
             const auto st_id = const_it[id_c].as<nt::idx_t>();
@@ -82,6 +82,9 @@ private:
 
     // stop_times by vj idx
     std::unordered_map<idx_t, std::vector<navitia::type::StopTime>> sts_from_vj;
+    // shapes by order of the stop time, set on the vj once it is created
+    std::unordered_map<idx_t, std::vector<std::pair<uint16_t, boost::shared_ptr<navitia::type::LineString>>>>
+    shapes_from_vj;
 
     //we need a temporary structure to store the comments on the stop times
     std::unordered_map<idx_t, std::vector<std::string>> stop_time_comments;
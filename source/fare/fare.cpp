@@ -35,6 +35,7 @@ www.navitia.io
 #include <boost/lexical_cast.hpp>
 
 #include "type/datetime.h"
+#include "type/tracing.h"
 
 namespace greg = boost::gregorian;
 
@@ -125,6 +126,7 @@ std::string comp_to_string(const Comp_e comp) {
 }
 
 results Fare::compute_fare(const routing::Path& path) const {
+    tracing::Span span("fare.compute_fare");
     results res;
     int nb_nodes = boost::num_vertices(g);
 
@@ -91,7 +91,7 @@ BOOST_AUTO_TEST_CASE(test_protobuff) {
     type::EntryPoint origin(type::Type_e::StopArea, "stop1");
     type::EntryPoint destination(type::Type_e::StopArea, "stop5");
 
-    georef::StreetNetwork sn_worker(*b.data->geo_ref);
+    georef::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {test::to_posix_timestamp("20120614T080000")},
                                              true, type::AccessibiliteParams(), {}, sn_worker, type::RTLevel::Base,
                                              boost::gregorian::not_a_date_time,
@@ -161,7 +161,7 @@ BOOST_AUTO_TEST_CASE(test_protobuff_no_data) {
     type::EntryPoint origin(type::Type_e::StopArea, "stop1");
     type::EntryPoint destination(type::Type_e::StopArea, "stop5");
 
-    georef::StreetNetwork sn_worker(*b.data->geo_ref);
+    georef::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {test::to_posix_timestamp("20120614T080000")},
                                              true, type::AccessibiliteParams(), {}, sn_worker,
                                              type::RTLevel::Base, boost::gregorian::not_a_date_time, 2_min);
@@ -64,10 +64,8 @@ namespace navitia {
             nt::GeographicalCoord coord;
             polygon_type boundary;
             std::vector<const Admin*> admin_list;
-            std::vector<const nt::StopArea*> main_stop_areas;
-
-            // TODO ODT NTFSv0.3: remove that when we stop to support NTFSv0.1
-            std::vector<const nt::StopPoint*> odt_stop_points; // zone odt stop points for the admin
+            // the main stop areas and the odt stop points of the admin are
+            // in PT_Data::admin_main_stop_areas and admin_odt_stop_points
             std::vector<std::string> postal_codes;
 
             Admin():level(-1){}
@@ -76,7 +74,7 @@ namespace navitia {
             std::string postal_codes_to_string() const;
             template<class Archive> void serialize(Archive & ar, const unsigned int ) {
                 ar & idx & level & from_original_dataset & insee
-                        & name & uri & coord & admin_list & main_stop_areas & label & odt_stop_points & postal_codes;
+                        & name & uri & coord & admin_list & label & postal_codes;
             }
         };
     }
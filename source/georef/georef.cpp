@@ -500,7 +500,7 @@ std::vector<nf::Autocomplete<nt::idx_t>::fl_quality> GeoRef::find_ways(const std
     return to_return;
 }
 
-void GeoRef::project_stop_points(const std::vector<type::StopPoint*> &stop_points) {
+ProjectedStopPoints GeoRef::project_stop_points(const std::vector<type::StopPoint*> &stop_points) const {
    enum class error {
        matched = 0,
        matched_walking,
@@ -513,13 +513,13 @@ void GeoRef::project_stop_points(const std::vector<type::StopPoint*> &stop_point
    };
    navitia::flat_enum_map<error, int> messages {{{}}};
 
-   this->projected_stop_points.clear();
-   this->projected_stop_points.reserve(stop_points.size());
+   ProjectedStopPoints res;
+   res.projections.reserve(stop_points.size());
 
    for(const type::StopPoint* stop_point : stop_points) {
        std::pair<GeoRef::ProjectionByMode, bool> pair = project_stop_point(stop_point);
 
-       this->projected_stop_points.push_back(pair.first);
+       res.projections.push_back(pair.first);
        if (pair.second) {
            messages[error::matched] += 1;
        } else {
@@ -567,6 +567,7 @@ void GeoRef::project_stop_points(const std::vector<type::StopPoint*> &stop_point
        LOG4CPLUS_DEBUG(log, "Number of stop point rejected (other issues)"
                        << messages[error::other]);
    }
+   return res;
 }
 
 std::vector<Admin*> GeoRef::find_admins(const type::GeographicalCoord& coord) const {
@@ -203,6 +203,7 @@ struct Path {
 };
 
 struct ProjectionData;
+struct ProjectedStopPoints;
 
 struct POI;
 struct POIType;
@@ -237,9 +238,9 @@ struct GeoRef {
     /// Indexe tous les nœuds
     proximitylist::ProximityList<vertex_t> pl;
 
-    /// for all stop_point, we store it's projection on each graph
+    /// projection of a stop point on each graph, the projections of the
+    /// stop points are in a ProjectedStopPoints
     typedef flat_enum_map<nt::Mode_e, ProjectionData> ProjectionByMode;
-    std::vector<ProjectionByMode> projected_stop_points = {};
 
     /// Graphe pour effectuer le calcul d'itinéraire
     Graph graph;
@@ -265,7 +266,7 @@ struct GeoRef {
     void init();
 
     template<class Archive> void save(Archive & ar, const unsigned int) const {
-        ar & ways & way_map & graph & offsets & fl_admin & fl_way & pl & projected_stop_points
+        ar & ways & way_map & graph & offsets & fl_admin & fl_way & pl
                 & admins & admin_map &  pois & fl_poi & poitypes & poitype_map & poi_map & synonyms
                 & ghostwords & poi_proximity_list & nb_vertex_by_mode;
     }
@@ -274,7 +275,7 @@ struct GeoRef {
         // La désérialisation d'une boost adjacency list ne vide pas le graphe
         // On avait donc une fuite de mémoire
         graph.clear();
-        ar & ways & way_map & graph & offsets & fl_admin & fl_way & pl & projected_stop_points
+        ar & ways & way_map & graph & offsets & fl_admin & fl_way & pl
                 & admins & admin_map & pois & fl_poi & poitypes & poitype_map & poi_map & synonyms
                 & ghostwords & poi_proximity_list & nb_vertex_by_mode;
     }
@@ -304,7 +305,7 @@ struct GeoRef {
     /**
      * Project each stop_point on the georef network
      */
-    void project_stop_points(const std::vector<type::StopPoint*> & stop_points);
+    ProjectedStopPoints project_stop_points(const std::vector<type::StopPoint*> & stop_points) const;
 
     /** project the stop point on all transportation mode
       * return a pair with :
@@ -395,6 +396,22 @@ struct ProjectionData {
     vertex_t operator[] (Direction d) const { return vertices[d]; }
 };
 
+/** Projection of each stop point on the graphs, by stop point idx
+ *
+ * It depends on the stop points of the pt data, thus it is not in the
+ * GeoRef: the GeoRef can be shared by several Data.
+ */
+struct ProjectedStopPoints {
+    std::vector<GeoRef::ProjectionByMode> projections;
+
+    const GeoRef::ProjectionByMode& operator[](type::idx_t idx) const { return projections[idx]; }
+    size_t size() const { return projections.size(); }
+
+    template<class Archive> void serialize(Archive & ar, const unsigned int) {
+        ar & projections;
+    }
+};
+
 /** Nommage d'un POI (point of interest). **/
 struct POIType : public nt::Nameable, nt::Header{
     const static type::Type_e type = type::Type_e::POIType;
@@ -31,6 +31,7 @@ www.navitia.io
 #include "street_network.h"
 #include "type/data.h"
 #include "georef.h"
+#include "type/tracing.h"
 #include <boost/math/constants/constants.hpp>
 #include <chrono>
 #ifdef _DEBUG_DIJKSTRA_QUANTUM_
@@ -61,11 +62,12 @@ navitia::time_duration PathFinder::path_duration_on_same_edge(const ProjectionDa
 }
 
 
-StreetNetwork::StreetNetwork(const GeoRef &geo_ref) :
+StreetNetwork::StreetNetwork(const GeoRef &geo_ref, const ProjectedStopPoints& projected_stop_points) :
     geo_ref(geo_ref),
-    departure_path_finder(geo_ref),
-    arrival_path_finder(geo_ref),
-    direct_path_finder(geo_ref)
+    projected_stop_points(projected_stop_points),
+    departure_path_finder(geo_ref, projected_stop_points),
+    arrival_path_finder(geo_ref, projected_stop_points),
+    direct_path_finder(geo_ref, projected_stop_points)
 {}
 
 void StreetNetwork::init(const type::EntryPoint& start, boost::optional<const type::EntryPoint&> end) {
@@ -169,7 +171,8 @@ StreetNetwork::get_direct_path(const type::EntryPoint& origin, const type::Entry
     return res;
 }
 
-PathFinder::PathFinder(const GeoRef& gref) : geo_ref(gref) {}
+PathFinder::PathFinder(const GeoRef& gref, const ProjectedStopPoints& projected_stop_points) :
+    geo_ref(gref), projected_stop_points(projected_stop_points) {}
 
 void PathFinder::init(const type::GeographicalCoord& start_coord, nt::Mode_e mode, const float speed_factor) {
     computation_launch = false;
@@ -217,6 +220,7 @@ void PathFinder::init(const type::GeographicalCoord& start_coord, nt::Mode_e mod
 void PathFinder::start_distance_dijkstra(const navitia::time_duration& radius) {
     if (! starting_edge.found)
         return ;
+    tracing::Span span("path_finder.dijkstra");
     computation_launch = true;
     // We start dijkstra from source and target nodes
     try {
@@ -249,6 +253,7 @@ PathFinder::crow_fly_find_nearest_stop_points(const navitia::time_duration& radi
 routing::map_stop_point_duration
 PathFinder::find_nearest_stop_points(const navitia::time_duration& radius,
                                      const proximitylist::ProximityList<type::idx_t>& pl) {
+    tracing::Span span("path_finder.find_nearest_stop_points");
     auto elements = crow_fly_find_nearest_stop_points(radius, pl);
     routing::map_stop_point_duration result;
     if (! starting_edge.found){
@@ -285,7 +290,7 @@ PathFinder::find_nearest_stop_points(const navitia::time_duration& radius,
 
     const auto max = bt::pos_infin;
     for (auto element: elements) {
-        ProjectionData projection = this->geo_ref.projected_stop_points[element.first][mode];
+        ProjectionData projection = this->projected_stop_points[element.first][mode];
         // the stop point has been projected on the graph?
         if(projection.found){
             //if our two points are projected on the same edge the Dijkstra won't give us the correct value
@@ -321,7 +326,7 @@ navitia::time_duration PathFinder::get_distance(type::idx_t target_idx) {
         return max;
     assert(boost::edge(starting_edge[source_e], starting_edge[target_e], geo_ref.graph).second);
 
-    ProjectionData target = this->geo_ref.projected_stop_points[target_idx][mode];
+    ProjectionData target = this->projected_stop_points[target_idx][mode];
 
     auto nearest_edge = update_path(target);
 
@@ -357,7 +362,7 @@ std::pair<navitia::time_duration, ProjectionData::Direction> PathFinder::find_ne
 Path PathFinder::get_path(type::idx_t idx) {
     if (! computation_launch)
         return {};
-    ProjectionData projection = this->geo_ref.projected_stop_points[idx][mode];
+    ProjectionData projection = this->projected_stop_points[idx][mode];
 
     auto nearest_edge = find_nearest_vertex(projection);
 
@@ -448,6 +453,7 @@ PathFinder::get_path(const ProjectionData& target,
 {
     if (! computation_launch || ! target.found || nearest_edge.first == bt::pos_infin)
         return {};
+    tracing::Span span("path_finder.get_path");
 
     Path result;
     if(is_projected_on_same_edge(starting_edge, target)){
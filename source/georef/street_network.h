@@ -98,6 +98,7 @@ struct TransportationModeFilter {
 
 struct PathFinder {
     const GeoRef & geo_ref;
+    const ProjectedStopPoints & projected_stop_points;
 
     bool computation_launch = false;
 
@@ -118,7 +119,7 @@ struct PathFinder {
     /// Predecessors array for the Dijkstra
     std::vector<vertex_t> predecessors;
 
-    PathFinder(const GeoRef& geo_ref);
+    PathFinder(const GeoRef& geo_ref, const ProjectedStopPoints& projected_stop_points);
 
     /**
      *  Update the structure for a given starting point and transportation mode
@@ -202,7 +203,7 @@ private:
 
 /** Structure managing the computation on the streetnetwork */
 struct StreetNetwork {
-    StreetNetwork(const GeoRef& geo_ref);
+    StreetNetwork(const GeoRef& geo_ref, const ProjectedStopPoints& projected_stop_points);
 
     void init(const type::EntryPoint& start_coord, boost::optional<const type::EntryPoint&> end_coord = {});
 
@@ -223,6 +224,7 @@ struct StreetNetwork {
     Path get_direct_path(const type::EntryPoint& origin, const type::EntryPoint& destination);
 
     const GeoRef & geo_ref;
+    const ProjectedStopPoints & projected_stop_points;
     PathFinder departure_path_finder;
     PathFinder arrival_path_finder;
     PathFinder direct_path_finder;
@@ -273,7 +273,8 @@ BOOST_AUTO_TEST_CASE(compute_directions_test) {
 
     b.geo_ref.init();
 
-    PathFinder path_finder(b.geo_ref);
+    const ProjectedStopPoints no_stop_points;
+    PathFinder path_finder(b.geo_ref, no_stop_points);
     path_finder.init({0, 0, true}, Mode_e::Walking, 1); //starting from a
     Path p = compute_path(path_finder, {4, 4, true}); //going to e
     BOOST_REQUIRE_EQUAL(p.path_items.size(), 2);
@@ -294,7 +295,8 @@ BOOST_AUTO_TEST_CASE(compute_directions_test) {
 BOOST_AUTO_TEST_CASE(compute_coord){
     using namespace navitia::type;
     GraphBuilder b;
-    PathFinder path_finder(b.geo_ref);
+    const ProjectedStopPoints no_stop_points;
+    PathFinder path_finder(b.geo_ref, no_stop_points);
 
     /*           a+------+b
      *            |      |
@@ -400,11 +402,11 @@ BOOST_AUTO_TEST_CASE(compute_nearest){
     std::vector<StopPoint*> stop_points;
     stop_points.push_back(sp1);
     stop_points.push_back(sp2);
-    b.geo_ref.project_stop_points(stop_points);
+    const auto projected_stop_points = b.geo_ref.project_stop_points(stop_points);
 
     GeographicalCoord o(0,0);
 
-    StreetNetwork w(b.geo_ref);
+    StreetNetwork w(b.geo_ref, projected_stop_points);
     EntryPoint starting_point;
     starting_point.coordinates = o;
     starting_point.streetnetwork_params.mode = Mode_e::Walking;
@@ -807,9 +809,9 @@ BOOST_AUTO_TEST_CASE(two_scc) {
     std::vector<StopPoint*> stop_points;
     stop_points.push_back(sp1);
     stop_points.push_back(sp2);
-    b.geo_ref.project_stop_points(stop_points);
+    const auto projected_stop_points = b.geo_ref.project_stop_points(stop_points);
 
-    StreetNetwork w(b.geo_ref);
+    StreetNetwork w(b.geo_ref, projected_stop_points);
 
     EntryPoint starting_point;
     starting_point.coordinates = c1;
@@ -1082,10 +1084,10 @@ BOOST_AUTO_TEST_CASE(find_nearest_on_same_edge){
     stop_points.push_back(sp1);
     stop_points.push_back(sp2);
     stop_points.push_back(sp3);
-    b.geo_ref.project_stop_points(stop_points);
+    const auto projected_stop_points = b.geo_ref.project_stop_points(stop_points);
 
 
-    StreetNetwork w(b.geo_ref);
+    StreetNetwork w(b.geo_ref, projected_stop_points);
     EntryPoint starting_point;
     starting_point.coordinates = c3;
     starting_point.streetnetwork_params.mode = Mode_e::Walking;
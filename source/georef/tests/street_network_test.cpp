@@ -100,7 +100,8 @@ BOOST_AUTO_TEST_CASE(idempotence) {
         }
     }
 
-    PathFinder worker(b.geo_ref);
+    ProjectedStopPoints projected_stop_points;
+    PathFinder worker(b.geo_ref, projected_stop_points);
 
     //we project 2 stations
     type::GeographicalCoord start;
@@ -111,9 +112,9 @@ BOOST_AUTO_TEST_CASE(idempotence) {
     sp->idx = 0;
     data.pt_data->stop_points.push_back(sp);
     b.geo_ref.init();
-    b.geo_ref.project_stop_points(data.pt_data->stop_points);
+    projected_stop_points = b.geo_ref.project_stop_points(data.pt_data->stop_points);
 
-    const GeoRef::ProjectionByMode& projections = b.geo_ref.projected_stop_points[sp->idx];
+    const GeoRef::ProjectionByMode& projections = projected_stop_points[sp->idx];
     const ProjectionData proj = projections[type::Mode_e::Walking];
 
     BOOST_REQUIRE(proj.found); //we have to be able to project this point (on the walking graph)
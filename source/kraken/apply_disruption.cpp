@@ -126,6 +126,17 @@ static type::ValidityPattern compute_base_disrupted_vp(
     return vp;
 }
 
+// Copy the shapes of the stop times kept from the vj from, when their
+// previous stop time is also kept.
+static void copy_shapes(const nt::VehicleJourney& from,
+                        nt::VehicleJourney& to,
+                        const std::vector<uint16_t>& kept_orders) {
+    for (size_t i = 1; i < kept_orders.size(); ++i) {
+        if (kept_orders[i - 1] + 1 != kept_orders[i]) { continue; }
+        to.set_shape_from_prev(i, from.get_shape_from_prev(kept_orders[i]));
+    }
+}
+
 static std::string concatenate_impact_uris(const nt::MetaVehicleJourney& mvj) {
     std::stringstream impacts_uris;
     for (auto& mvj_impacts : mvj.impacted_by) {
@@ -268,6 +279,7 @@ struct add_impacts_visitor : public apply_impacts_visitor {
             auto& new_vp = std::get<1>(vj_vp_section);
             auto& bounds_st = std::get<2>(vj_vp_section);
 
+            std::vector<uint16_t> kept_orders;
             bool ignore_stop(false);
             for (const auto& st : vj->stop_time_list) {
                 // Ignore stop if it's the range of impacted stop_times
@@ -278,6 +290,7 @@ struct add_impacts_visitor : public apply_impacts_visitor {
                     ignore_stop = !(st.order() == *(bounds_st.second));
                     continue;
                 }
+                kept_orders.push_back(st.order());
                 nt::StopTime new_st = st.clone();
                 new_st.arrival_time = st.arrival_time + ndtu::SECONDS_PER_DAY * vj->shift;
                 new_st.departure_time = st.departure_time + ndtu::SECONDS_PER_DAY * vj->shift;
@@ -308,6 +321,7 @@ struct add_impacts_visitor : public apply_impacts_visitor {
                     pt_data);
 
             LOG4CPLUS_TRACE(log, "new_vj: "<< new_vj->uri << " is created");
+            copy_shapes(*vj, *new_vj, kept_orders);
 
             if (! mvj->get_base_vj().empty()) {
                 new_vj->physical_mode = mvj->get_base_vj().at(0)->physical_mode;
@@ -440,10 +454,12 @@ struct add_impacts_visitor : public apply_impacts_visitor {
             const auto* vj = vj_vp.first;
             auto& new_vp = vj_vp.second;
 
+            std::vector<uint16_t> kept_orders;
             for (const auto& st : vj->stop_time_list) {
                 if (st.stop_point == stop_point) {
                     continue;
                 }
+                kept_orders.push_back(st.order());
                 nt::StopTime new_st = st.clone();
                 // Here the first arrival/departure time may be > 24hours.
                 // Check the test case: apply_disruption_test/test_shift_of_a_disrupted_delayed_train for more details
@@ -470,6 +486,7 @@ struct add_impacts_visitor : public apply_impacts_visitor {
                     pt_data);
             
             LOG4CPLUS_TRACE(log,  "new_vj: "<< new_vj->uri << " is created");
+            copy_shapes(*vj, *new_vj, kept_orders);
 
             if (! mvj->get_base_vj().empty()) {
                 new_vj->physical_mode = mvj->get_base_vj().at(0)->physical_mode;
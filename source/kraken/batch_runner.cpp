@@ -0,0 +1,130 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "batch_runner.h"
+#include "kraken/worker.h"
+#include "kraken/worker_classes.h"
+#include "type/datetime.h"
+#include "type/meta_data.h"
+#include "utils/exception.h"
+#include "utils/zmq.h"
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+namespace navitia { namespace kraken {
+
+BatchRunner::BatchRunner(DataManager<type::Data>& data_manager, const Configuration& conf, int nb_threads):
+    data_manager(data_manager) {
+    for (int i = 0; i < nb_threads; ++i) {
+        workers.push_back(std::make_unique<Worker>(batch_data, conf));
+    }
+}
+
+BatchRunner::~BatchRunner() {}
+
+static pbnavitia::Response run_one(Worker& worker, const std::string& request, const type::Data& data) {
+    pbnavitia::Request pb_req;
+    pbnavitia::Response response;
+    if (! pb_req.ParseFromString(request)) {
+        response.mutable_error()->set_id(pbnavitia::Error::invalid_protobuf_request);
+        return response;
+    }
+    try {
+        auto dispatched = worker.dispatch(pb_req);
+        response.Swap(&dispatched);
+    } catch (const recoverable_exception& e) {
+        response.mutable_error()->set_id(pbnavitia::Error::internal_error);
+        response.mutable_error()->set_message(e.what());
+    }
+    if (! data.loaded) {
+        response.set_publication_date(-1);
+    } else {
+        response.set_publication_date(to_posix_timestamp(data.meta->publication_date));
+    }
+    return response;
+}
+
+std::vector<pbnavitia::Response> BatchRunner::run(const std::vector<std::string>& requests) {
+    // all the requests of the batch see the same data, even if it is reloaded meanwhile
+    batch_data.share_data(data_manager);
+    const auto data = batch_data.get_data();
+
+    std::vector<pbnavitia::Response> responses(requests.size());
+    std::atomic<size_t> next(0);
+    auto run_requests = [&](Worker& worker) {
+        for (size_t i = next++; i < requests.size(); i = next++) {
+            auto response = run_one(worker, requests[i], *data);
+            responses[i].Swap(&response);
+        }
+    };
+    const size_t nb_threads = std::min(workers.size(), requests.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nb_threads; ++i) {
+        threads.emplace_back(run_requests, std::ref(*workers[i]));
+    }
+    if (nb_threads > 0) { run_requests(*workers[0]); }
+    for (auto& thread: threads) { thread.join(); }
+    return responses;
+}
+
+void BatchRunner::serve(zmq::context_t& context, const std::string& socket_path) {
+    zmq::socket_t socket(context, ZMQ_PAIR);
+    socket.connect(socket_path.c_str());
+    while (true) {
+        const std::string client = z_recv(socket);
+        {
+            std::string empty = z_recv(socket);
+            assert(empty.size() == 0);
+        }
+        std::vector<std::string> requests;
+        do {
+            zmq::message_t frame;
+            socket.recv(&frame);
+            requests.emplace_back(static_cast<const char*>(frame.data()), frame.size());
+        } while (has_more_frames(socket));
+
+        const auto start = boost::posix_time::microsec_clock::universal_time();
+        const auto responses = run(requests);
+        z_send(socket, client, ZMQ_SNDMORE);
+        z_send(socket, "", ZMQ_SNDMORE);
+        for (size_t i = 0; i < responses.size(); ++i) {
+            const int size = responses[i].ByteSize();
+            zmq::message_t reply(size);
+            responses[i].SerializeWithCachedSizesToArray(static_cast<google::protobuf::uint8*>(reply.data()));
+            socket.send(reply, i + 1 < responses.size() ? ZMQ_SNDMORE : 0);
+        }
+        LOG4CPLUS_DEBUG(logger, "batch of " << requests.size() << " requests processed in "
+                        << (boost::posix_time::microsec_clock::universal_time() - start).total_milliseconds()
+                        << "ms");
+    }
+}
+
+}} // namespace navitia::kraken
@@ -0,0 +1,76 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "kraken/data_manager.h"
+#include "kraken/configuration.h"
+#include "type/data.h"
+#include "type/response.pb.h"
+#include "utils/logger.h"
+#include <zmq.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace navitia {
+class Worker;
+
+namespace kraken {
+
+/**
+ * Runs the batches of requests
+ *
+ * A batch is a multipart message, a serialized pbnavitia::Request per
+ * frame. Its reply has a pbnavitia::Response per frame, in the same
+ * order, an invalid request only getting an error in its own response.
+ *
+ * The requests of a batch are spread over the threads of the runner, all
+ * of them on the data loaded when the batch started. The runner has its
+ * own threads, a batch doesn't hold the workers of the requests.
+ */
+class BatchRunner {
+    DataManager<type::Data>& data_manager;
+    /// the data of the current batch, the workers of the runner use it
+    DataManager<type::Data> batch_data;
+    std::vector<std::unique_ptr<Worker>> workers;
+    log4cplus::Logger logger = log4cplus::Logger::getInstance("batch");
+
+public:
+    BatchRunner(DataManager<type::Data>& data_manager, const Configuration& conf, int nb_threads);
+    ~BatchRunner();
+
+    std::vector<pbnavitia::Response> run(const std::vector<std::string>& requests);
+
+    /// receive the batches from the load balancer and reply them, never returns
+    void serve(zmq::context_t& context, const std::string& socket_path);
+};
+
+}} // namespace navitia::kraken
@@ -0,0 +1,157 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+// Throughput of the two ways of giving the requests to the workers: the
+// ClassLoadBalancer with its READY handshake, and the QueueFrontend.
+// The workers only echo the requests, after an optional busy loop, so
+// the dispatching itself is measured.
+
+#include "kraken/worker_classes.h"
+#include "kraken/queue_frontend.h"
+#include "utils/init.h"
+#include "utils/zmq.h"
+#include <boost/program_options.hpp>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace po = boost::program_options;
+namespace nk = navitia::kraken;
+
+static const std::string clients_socket = "inproc://clients";
+
+static void busy_wait(int work_us) {
+    const auto end = std::chrono::steady_clock::now() + std::chrono::microseconds(work_us);
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+static void lb_worker(zmq::context_t& context, const std::string& socket_path, int work_us) {
+    zmq::socket_t socket(context, ZMQ_REQ);
+    socket.connect(socket_path.c_str());
+    z_send(socket, "READY");
+    while (true) {
+        const std::string address = z_recv(socket);
+        z_recv(socket);
+        zmq::message_t request;
+        socket.recv(&request);
+        busy_wait(work_us);
+        z_send(socket, address, ZMQ_SNDMORE);
+        z_send(socket, "", ZMQ_SNDMORE);
+        socket.send(request);
+    }
+}
+
+static void queue_worker(zmq::context_t& context, nk::RequestQueue& queue,
+                         const std::string& replies_socket, int work_us) {
+    zmq::socket_t replies(context, ZMQ_PUSH);
+    replies.connect(replies_socket.c_str());
+    while (true) {
+        auto request = queue.pop();
+        busy_wait(work_us);
+        nk::send_reply(replies, request.client, request.request);
+    }
+}
+
+// the requests per second of nb_clients clients, each sending its requests one after the other
+static double run_clients(zmq::context_t& context, int nb_clients, int nb_requests) {
+    pbnavitia::Request request;
+    request.set_requested_api(pbnavitia::places);
+    const std::string serialized = request.SerializeAsString();
+
+    std::atomic<int> nb_ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> clients;
+    for (int i = 0; i < nb_clients; ++i) {
+        clients.emplace_back([&]() {
+            zmq::socket_t socket(context, ZMQ_REQ);
+            socket.connect(clients_socket.c_str());
+            ++nb_ready;
+            while (! go) { std::this_thread::yield(); }
+            for (int r = 0; r < nb_requests; ++r) {
+                z_send(socket, serialized);
+                z_recv(socket);
+            }
+        });
+    }
+    while (nb_ready < nb_clients) { std::this_thread::yield(); }
+    const auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& client: clients) { client.join(); }
+    const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return nb_clients * nb_requests / duration.count();
+}
+
+int main(int argc, char** argv) {
+    navitia::init_app();
+    po::options_description desc("Throughput of the kraken frontends");
+    int nb_threads, nb_clients, nb_requests, work_us;
+    desc.add_options()
+            ("help", "Show this message")
+            ("threads,t", po::value<int>(&nb_threads)->default_value(8), "Number of workers")
+            ("clients,c", po::value<int>(&nb_clients)->default_value(32), "Number of concurrent clients")
+            ("requests,r", po::value<int>(&nb_requests)->default_value(20000), "Number of requests by client")
+            ("work,w", po::value<int>(&work_us)->default_value(0), "Work of a worker by request, in microseconds");
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+    if (vm.count("help")) {
+        std::cout << desc << std::endl;
+        return 0;
+    }
+    const auto classes = nk::parse_worker_classes({}, nb_threads, 0);
+
+    // the frontends never return: the threads are detached and the contexts leaked
+    {
+        auto* context = new zmq::context_t(1);
+        auto* lb = new nk::ClassLoadBalancer(*context, classes);
+        lb->bind(clients_socket);
+        std::thread([lb]() { lb->run(); }).detach();
+        for (int i = 0; i < nb_threads; ++i) {
+            std::thread(lb_worker, std::ref(*context), classes[0].socket_path(), work_us).detach();
+        }
+        const double throughput = run_clients(*context, nb_clients, nb_requests);
+        std::cout << "load_balancer: " << int(throughput) << " requests/s" << std::endl;
+    }
+    {
+        auto* context = new zmq::context_t(1);
+        auto* frontend = new nk::QueueFrontend(*context, classes);
+        frontend->bind(clients_socket);
+        std::thread([frontend]() { frontend->run(); }).detach();
+        for (int i = 0; i < nb_threads; ++i) {
+            std::thread(queue_worker, std::ref(*context), std::ref(frontend->queue(0)),
+                        frontend->replies_socket_path(), work_us).detach();
+        }
+        const double throughput = run_clients(*context, nb_clients, nb_requests);
+        std::cout << "queues: " << int(throughput) << " requests/s" << std::endl;
+    }
+    return 0;
+}
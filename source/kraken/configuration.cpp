@@ -53,17 +53,48 @@ po::options_description get_options_description(const boost::optional<std::strin
          "name of the instance")
 
         ("GENERAL.nb_threads", po::value<int>()->default_value(1), "number of workers threads")
+        ("GENERAL.max_queue", po::value<int>()->default_value(0),
+                              "max number of queued requests for the default workers, 0 for no limit")
+        ("GENERAL.worker_class", po::value<std::vector<std::string>>(),
+                                 "workers dedicated to some apis, as name:nb_threads:max_queue:API,API...")
+        ("GENERAL.frontend", po::value<std::string>()->default_value("load_balancer"),
+                             "how the requests are given to the workers: \"load_balancer\", or \"queues\" "
+                             "where the workers pop them from lock-free queues, lighter at high throughput")
+        ("GENERAL.nb_batch_threads", po::value<int>()->default_value(0),
+                                     "number of threads running the batches of requests, 0 to disable them")
+        ("GENERAL.metrics_socket", po::value<std::string>(),
+                                   "zmq socket answering the metrics of the requests as text, or the memory report "
+                                   "of the data to \"memory\", the chrome trace of the traced requests to \"trace\", "
+                                   "e.g. ipc:///tmp/kraken_metrics")
+        ("GENERAL.trace_sampling", po::value<int>()->default_value(0),
+                                   "trace one request out of this number on each worker thread, 0 to trace none")
+        ("GENERAL.warm_up_requests", po::value<std::string>(),
+                                     "file of requests replayed on a new data before using it, "
+                                     "each one is its size as a varint followed by the serialized request")
+        ("GENERAL.warm_up_budget", po::value<int>()->default_value(60),
+                                   "max duration in seconds of the warm up")
         ("GENERAL.is_realtime_enabled", po::value<bool>()->default_value(false),
                                         "enable loading of realtime data")
         ("GENERAL.kirin_timeout", po::value<int>()->default_value(60000),
                                   "timeout in ms for loading realtime data from kirin")
         ("GENERAL.kirin_retry_timeout", po::value<int>()->default_value(5*60*1000),
                                   "timeout in ms before retrying to load realtime data")
+        ("GENERAL.rt_snapshot", po::value<std::string>(),
+                                "file where the applied realtime is saved, and reapplied at startup "
+                                "instead of waiting for a full reload from kirin")
+        ("GENERAL.rt_snapshot_max_age", po::value<int>()->default_value(3600),
+                                        "max age in seconds of the realtime snapshot used at startup")
+        ("GENERAL.rt_snapshot_interval", po::value<int>()->default_value(60),
+                                         "min duration in seconds between two saves of the realtime snapshot, "
+                                         "the realtime messages are acked once saved")
 
         ("GENERAL.display_contributors", display_contributors ?
              po::value<bool>()->default_value(*display_contributors) : po::value<bool>()->default_value(false),
          "display all contributors in feed publishers")
         ("GENERAL.raptor_cache_size", po::value<int>()->default_value(10), "maximum number of stored raptor caches")
+        ("GENERAL.transfer_closure", po::value<int>()->default_value(0),
+                                     "max duration in seconds of the transfers chaining several stop point "
+                                     "connections added to the routing, 0 to disable them")
 
         ("BROKER.host", po::value<std::string>()->default_value("localhost"), "host of rabbitmq")
         ("BROKER.port", po::value<int>()->default_value(5672), "port of rabbitmq")
@@ -73,9 +104,22 @@ po::options_description get_options_description(const boost::optional<std::strin
         ("BROKER.exchange", po::value<std::string>()->default_value("navitia"), "exchange used in rabbitmq")
         ("BROKER.rt_topics", po::value<std::vector<std::string>>(), "list of realtime topic for this instance")
         ("BROKER.timeout", po::value<int>()->default_value(100), "timeout for maintenance worker in millisecond")
-        ("BROKER.sleeptime", po::value<int>()->default_value(1), "sleeptime for maintenance worker in second")
+        ("BROKER.sleeptime", po::value<int>()->default_value(1),
+                             "maximum sleeptime for maintenance worker in second, when the queues are empty")
+        ("BROKER.rt_latency_target", po::value<int>()->default_value(10000),
+                                     "targeted delay in millisecond between a realtime message and its use")
+        ("BROKER.rt_max_batch_size", po::value<int>()->default_value(5000),
+                                     "maximum number of realtime messages applied at once")
 
-        ("CHAOS.database", po::value<std::string>(), "Chaos database connection string");
+        ("CACHE.ttl", po::value<std::vector<std::string>>(),
+                      "api whose responses are cached, as API:ttl_in_seconds, no cache if empty")
+        ("CACHE.max_size", po::value<int>()->default_value(100), "memory budget of the response cache in MB")
+        ("CACHE.datetime_bucket", po::value<int>()->default_value(60),
+                                  "precision in seconds of the current datetime of the cached requests")
+
+        ("CHAOS.database", po::value<std::string>(), "Chaos database connection string")
+        ("CHAOS.nb_threads", po::value<int>()->default_value(1),
+                             "number of threads building the disruptions of chaos while the data loads");
 
     return desc;
 
@@ -119,6 +163,17 @@ boost::optional<std::string> Configuration::chaos_database() const{
     }
     return result;
 }
+int Configuration::nb_chaos_threads() const{
+    if (! vm.count("CHAOS.nb_threads")) {
+        return 1;
+    }
+    int nb_threads = vm["CHAOS.nb_threads"].as<int>();
+    if (nb_threads < 1) {
+        throw std::invalid_argument("CHAOS.nb_threads must be strictly positive");
+    }
+    return nb_threads;
+}
+
 int Configuration::nb_threads() const{
     int nb_threads = vm["GENERAL.nb_threads"].as<int>();
     if (nb_threads < 0) {
@@ -127,6 +182,147 @@ int Configuration::nb_threads() const{
     return size_t(nb_threads);
 }
 
+size_t Configuration::max_queue() const{
+    if (! vm.count("GENERAL.max_queue")) {
+        return 0;
+    }
+    int max_queue = vm["GENERAL.max_queue"].as<int>();
+    if (max_queue < 0) {
+        throw std::invalid_argument("max_queue cannot be negative");
+    }
+    return size_t(max_queue);
+}
+
+int Configuration::nb_batch_threads() const{
+    if (! vm.count("GENERAL.nb_batch_threads")) {
+        return 0;
+    }
+    int nb_batch_threads = vm["GENERAL.nb_batch_threads"].as<int>();
+    if (nb_batch_threads < 0) {
+        throw std::invalid_argument("nb_batch_threads cannot be negative");
+    }
+    return nb_batch_threads;
+}
+
+bool Configuration::use_queue_frontend() const{
+    if (! vm.count("GENERAL.frontend")) {
+        return false;
+    }
+    const auto frontend = vm["GENERAL.frontend"].as<std::string>();
+    if (frontend != "load_balancer" && frontend != "queues") {
+        throw std::invalid_argument("unknown frontend " + frontend + ", expected load_balancer or queues");
+    }
+    return frontend == "queues";
+}
+
+int Configuration::trace_sampling() const{
+    if (! vm.count("GENERAL.trace_sampling")) {
+        return 0;
+    }
+    return vm["GENERAL.trace_sampling"].as<int>();
+}
+
+boost::optional<std::string> Configuration::metrics_socket() const{
+    boost::optional<std::string> result;
+    if (this->vm.count("GENERAL.metrics_socket") > 0) {
+        result = this->vm["GENERAL.metrics_socket"].as<std::string>();
+    }
+    return result;
+}
+
+boost::optional<std::string> Configuration::warm_up_requests() const{
+    boost::optional<std::string> result;
+    if (this->vm.count("GENERAL.warm_up_requests") > 0) {
+        result = this->vm["GENERAL.warm_up_requests"].as<std::string>();
+    }
+    return result;
+}
+
+boost::optional<std::string> Configuration::rt_snapshot() const{
+    boost::optional<std::string> result;
+    if (this->vm.count("GENERAL.rt_snapshot") > 0) {
+        result = this->vm["GENERAL.rt_snapshot"].as<std::string>();
+    }
+    return result;
+}
+
+int Configuration::rt_snapshot_max_age() const{
+    int max_age = vm["GENERAL.rt_snapshot_max_age"].as<int>();
+    if (max_age < 0) {
+        throw std::invalid_argument("rt_snapshot_max_age cannot be negative");
+    }
+    return max_age;
+}
+
+int Configuration::rt_snapshot_interval() const{
+    if (! vm.count("GENERAL.rt_snapshot_interval")) {
+        return 60;
+    }
+    int interval = vm["GENERAL.rt_snapshot_interval"].as<int>();
+    if (interval < 0) {
+        throw std::invalid_argument("rt_snapshot_interval cannot be negative");
+    }
+    return interval;
+}
+
+int Configuration::transfer_closure() const{
+    if (! vm.count("GENERAL.transfer_closure")) {
+        return 0;
+    }
+    int transfer_closure = vm["GENERAL.transfer_closure"].as<int>();
+    if (transfer_closure < 0) {
+        throw std::invalid_argument("transfer_closure cannot be negative");
+    }
+    return transfer_closure;
+}
+
+int Configuration::warm_up_budget() const{
+    if (! vm.count("GENERAL.warm_up_budget")) {
+        return 60;
+    }
+    int warm_up_budget = vm["GENERAL.warm_up_budget"].as<int>();
+    if (warm_up_budget < 0) {
+        throw std::invalid_argument("warm_up_budget cannot be negative");
+    }
+    return warm_up_budget;
+}
+
+std::vector<std::string> Configuration::worker_classes() const{
+    if(! this->vm.count("GENERAL.worker_class")){
+        return std::vector<std::string>();
+    }
+    return this->vm["GENERAL.worker_class"].as<std::vector<std::string>>();
+}
+
+std::vector<std::string> Configuration::cache_ttls() const{
+    if(! this->vm.count("CACHE.ttl")){
+        return std::vector<std::string>();
+    }
+    return this->vm["CACHE.ttl"].as<std::vector<std::string>>();
+}
+
+size_t Configuration::cache_max_size() const{
+    if (! vm.count("CACHE.max_size")) {
+        return 100 * 1024 * 1024;
+    }
+    int max_size = vm["CACHE.max_size"].as<int>();
+    if (max_size < 0) {
+        throw std::invalid_argument("cache max_size cannot be negative");
+    }
+    return size_t(max_size) * 1024 * 1024;
+}
+
+int Configuration::cache_datetime_bucket() const{
+    if (! vm.count("CACHE.datetime_bucket")) {
+        return 60;
+    }
+    int bucket = vm["CACHE.datetime_bucket"].as<int>();
+    if (bucket < 1) {
+        throw std::invalid_argument("cache datetime_bucket must be strictly positive");
+    }
+    return bucket;
+}
+
 bool Configuration::is_realtime_enabled() const{
     return this->vm["GENERAL.is_realtime_enabled"].as<bool>();
 }
@@ -162,6 +358,14 @@ int Configuration::broker_sleeptime() const {
     return vm["BROKER.sleeptime"].as<int>();
 }
 
+int Configuration::rt_latency_target() const {
+    return vm["BROKER.rt_latency_target"].as<int>();
+}
+
+int Configuration::rt_max_batch_size() const {
+    return vm["BROKER.rt_max_batch_size"].as<int>();
+}
+
 std::vector<std::string> Configuration::rt_topics() const{
     if(! this->vm.count("BROKER.rt_topics")){
         return std::vector<std::string>();
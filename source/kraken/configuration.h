@@ -45,7 +45,23 @@ namespace navitia { namespace kraken{
             std::string zmq_socket_path() const;
             std::string instance_name() const;
             boost::optional<std::string> chaos_database() const;
+            int nb_chaos_threads() const;
             int nb_threads() const;
+            size_t max_queue() const;
+            int nb_batch_threads() const;
+            boost::optional<std::string> metrics_socket() const;
+            int trace_sampling() const;
+            bool use_queue_frontend() const;
+            boost::optional<std::string> warm_up_requests() const;
+            int warm_up_budget() const;
+            boost::optional<std::string> rt_snapshot() const;
+            int rt_snapshot_max_age() const;
+            int rt_snapshot_interval() const;
+            int transfer_closure() const;
+            std::vector<std::string> worker_classes() const;
+            std::vector<std::string> cache_ttls() const;
+            size_t cache_max_size() const;
+            int cache_datetime_bucket() const;
 
             std::string broker_host() const;
             int broker_port() const;
@@ -55,6 +71,8 @@ namespace navitia { namespace kraken{
             std::string broker_exchange() const;
             int broker_timeout() const;
             int broker_sleeptime() const;
+            int rt_latency_target() const;
+            int rt_max_batch_size() const;
             bool is_realtime_enabled() const;
             int kirin_timeout() const;
             int kirin_retry_timeout() const;
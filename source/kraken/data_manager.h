@@ -32,6 +32,7 @@ www.navitia.io
 
 #include "utils/timer.h"
 #include "utils/exception.h"
+#include "type/time_duration.h"
 #ifndef NO_FORCE_MEMORY_RELEASE
 //by default we force the release of the memory after the reload of the data
 #include "gperftools/malloc_extension.h"
@@ -40,6 +41,7 @@ www.navitia.io
 #include <memory>
 #include <iostream>
 #include <atomic>
+#include <functional>
 #include <boost/make_shared.hpp>
 #include <boost/optional.hpp>
 
@@ -81,6 +83,8 @@ public:
         current_data = std::move(data);
     }
     boost::shared_ptr<const Data> get_data() const { return current_data; }
+    /// use the current data of another manager, as is
+    void share_data(const DataManager& other) { current_data = other.current_data; }
     boost::shared_ptr<Data> get_data_clone() {
         ++ data_identifier;
         auto data = create_data(data_identifier.load());
@@ -88,14 +92,21 @@ public:
         return std::move(data);
     }
 
+    /// before_switch is called on the new data before it replaces the current one
     bool load(const std::string& database,
               const boost::optional<std::string>& chaos_database = boost::none,
-              const std::vector<std::string>& contributors = {}){
+              const std::vector<std::string>& contributors = {},
+              const std::function<void(const boost::shared_ptr<const Data>&)>& before_switch = {},
+              const navitia::time_duration& transfer_closure = navitia::seconds(0),
+              size_t nb_chaos_threads = 1){
         bool success;
         ++ data_identifier;
         auto data = create_data(data_identifier.load());
-        success = data->load(database, chaos_database, contributors);
+        // the current data is given to share what hasn't changed
+        success = data->load(database, chaos_database, contributors, current_data.get(), transfer_closure,
+                             nb_chaos_threads);
         if (success) {
+            if (before_switch) { before_switch(data); }
             set_data(std::move(data));
         }
         return success;
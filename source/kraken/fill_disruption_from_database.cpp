@@ -36,31 +36,16 @@ www.navitia.io
 
 #include <boost/format.hpp>
 #include <boost/algorithm/string/join.hpp>
+#include <algorithm>
 
 
 namespace navitia {
 
 
 
-void fill_disruption_from_database(const std::string& connection_string,
-        type::PT_Data& pt_data, type::MetaData &meta, const std::vector<std::string>& contributors) {
-    std::unique_ptr<pqxx::connection> conn;
-    try{
-        conn = std::unique_ptr<pqxx::connection>(new pqxx::connection(connection_string));
-    }catch(const pqxx::pqxx_exception& e){
-        throw navitia::exception(std::string("Unable to connect to chaos database: ")
-                + std::string(e.base().what()));
-    }
-    pqxx::work work(*conn, "loading disruptions");
-
-    size_t offset = 0,
-           items_per_request = 100;
-    DisruptionDatabaseReader reader(pt_data, meta);
-    pqxx::result result;
-    std::string contributors_array = boost::algorithm::join(contributors, ", ");
-    LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"), "Reading disruptions from database");
-    do{
-        std::string request = (boost::format(
+static std::string disruptions_query(const boost::gregorian::date_period& production_date,
+                                     const std::vector<std::string>& contributors) {
+    return (boost::format(
                "SELECT "
                // Disruptions field
                "     d.id as disruption_id, d.reference as disruption_reference, d.note as disruption_note,"
@@ -149,24 +134,175 @@ void fill_disruption_from_database(const std::string& connection_string,
                "     AND d.status = 'published'"
                "     AND i.status = 'published'"
                "     ORDER BY d.id, c.id, t.id, i.id, a.id, p.id, m.id, ch.id, cht.id"
-               "     LIMIT %i OFFSET %i"
-               " ;") %meta.production_date.end() % meta.production_date.begin() %meta.production_date.end()  % contributors_array % items_per_request % offset).str();
-        result = work.exec(request);
-        for (auto res : result) {
-            reader(res);
-        }
+               ) % production_date.end() % production_date.begin() % production_date.end()
+                 % boost::algorithm::join(contributors, ", ")).str();
+}
+
+void fill_disruption_from_database(const std::string& connection_string,
+        type::PT_Data& pt_data, type::MetaData &meta, const std::vector<std::string>& contributors,
+        size_t nb_threads) {
+    DisruptionDatabaseLoader loader(connection_string, meta.production_date, contributors, nb_threads);
+    loader.apply(pt_data, meta);
+}
+
+DisruptionDatabaseLoader::DisruptionDatabaseLoader(const std::string& connection_string,
+                                                   const boost::gregorian::date_period& production_date,
+                                                   const std::vector<std::string>& contributors,
+                                                   size_t nb_threads) {
+    threads.emplace_back([=]() { read(connection_string, production_date, contributors); });
+    for (size_t i = 0; i < std::max<size_t>(nb_threads, 1); ++i) {
+        threads.emplace_back([this]() { build(); });
+    }
+}
+
+DisruptionDatabaseLoader::~DisruptionDatabaseLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        is_stopped = true;
+    }
+    cond.notify_all();
+    for (auto& thread: threads) { thread.join(); }
+}
+
+void DisruptionDatabaseLoader::fail(std::exception_ptr e) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (! error) { error = e; }
+        is_stopped = true;
+    }
+    cond.notify_all();
+}
+
+void DisruptionDatabaseLoader::push_chunk(std::vector<Segment> segments) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        chunks.emplace_back();
+        chunks.back().segments = std::move(segments);
+    }
+    cond.notify_all();
+}
 
-        offset += result.size();
+void DisruptionDatabaseLoader::read(const std::string& connection_string,
+                                    const boost::gregorian::date_period& production_date,
+                                    const std::vector<std::string>& contributors) {
+    auto logger = log4cplus::Logger::getInstance("Logger");
+    try {
+        std::unique_ptr<pqxx::connection> conn;
+        try{
+            conn = std::unique_ptr<pqxx::connection>(new pqxx::connection(connection_string));
+        }catch(const pqxx::pqxx_exception& e){
+            throw navitia::exception(std::string("Unable to connect to chaos database: ")
+                    + std::string(e.base().what()));
+        }
+        pqxx::work work(*conn, "loading disruptions");
+        LOG4CPLUS_INFO(logger, "Reading disruptions from database");
+        const std::string request = disruptions_query(production_date, contributors);
         LOG4CPLUS_TRACE(log4cplus::Logger::getInstance("sql"), request);
-    }while(result.size() > 0);    
-    LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"),"Loading " << offset << " disruptions");
-    reader.finalize();
-    LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"),offset << " disruptions loaded");
+        // a cursor instead of LIMIT/OFFSET pages, which make the database sort and skip the
+        // previous rows again for each page
+        work.exec("DECLARE disruptions_cursor NO SCROLL CURSOR FOR " + request);
+        const std::string fetch = "FETCH " + std::to_string(rows_per_fetch) + " FROM disruptions_cursor";
+
+        // the rows of the last disruption of a page can go on in the next page
+        std::vector<Segment> pending;
+        while (true) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (is_stopped) { return; }
+            }
+            auto rows = std::make_shared<const pqxx::result>(work.exec(fetch));
+            const size_t size = rows->size();
+            if (size == 0) { break; }
+            nb_rows += size;
+            const auto last_id = (*rows)[size - 1]["disruption_id"].as<std::string>();
+            size_t last_begin = size - 1;
+            while (last_begin > 0 && (*rows)[last_begin - 1]["disruption_id"].as<std::string>() == last_id) {
+                --last_begin;
+            }
+            if (last_begin > 0) {
+                pending.push_back({rows, 0, last_begin});
+                push_chunk(std::move(pending));
+                pending.clear();
+            }
+            pending.push_back({rows, last_begin, size});
+        }
+        if (! pending.empty()) {
+            push_chunk(std::move(pending));
+        }
+        work.exec("CLOSE disruptions_cursor");
+        LOG4CPLUS_INFO(logger, nb_rows << " rows of disruptions read");
+    } catch (const pqxx::pqxx_exception& e) {
+        fail(std::make_exception_ptr(navitia::exception(std::string("Unable to read the chaos database: ")
+                                                        + std::string(e.base().what()))));
+    } catch (...) {
+        fail(std::current_exception());
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        is_read = true;
+    }
+    cond.notify_all();
+}
+
+void DisruptionDatabaseLoader::build() {
+    while (true) {
+        Chunk* chunk = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() { return is_stopped || is_read || next_to_build < chunks.size(); });
+            if (is_stopped || next_to_build == chunks.size()) { return; }
+            chunk = &chunks[next_to_build++];
+        }
+        std::vector<std::unique_ptr<chaos::Disruption>> disruptions;
+        try {
+            DisruptionDatabaseReader reader([&](std::unique_ptr<chaos::Disruption> d) {
+                disruptions.push_back(std::move(d));
+            });
+            for (const auto& segment: chunk->segments) {
+                for (size_t i = segment.begin; i < segment.end; ++i) {
+                    reader((*segment.rows)[i]);
+                }
+            }
+            reader.finalize();
+        } catch (...) {
+            fail(std::current_exception());
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            chunk->disruptions = std::move(disruptions);
+            chunk->segments.clear();
+            chunk->is_built = true;
+        }
+        cond.notify_all();
+    }
+}
+
+void DisruptionDatabaseLoader::apply(type::PT_Data& pt_data, const type::MetaData& meta) {
+    size_t nb_disruptions = 0;
+    for (size_t i = 0;; ++i) {
+        std::vector<std::unique_ptr<chaos::Disruption>> disruptions;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cond.wait(lock, [&]() {
+                return error || (i < chunks.size() && chunks[i].is_built) || (is_read && i == chunks.size());
+            });
+            if (error) { std::rethrow_exception(error); }
+            if (i == chunks.size()) { break; }
+            disruptions = std::move(chunks[i].disruptions);
+        }
+        // the impacts modify pt_data, they are applied one after the other
+        for (const auto& disruption: disruptions) {
+            make_and_apply_disruption(*disruption, pt_data, meta);
+        }
+        nb_disruptions += disruptions.size();
+    }
+    LOG4CPLUS_INFO(log4cplus::Logger::getInstance("Logger"), nb_disruptions << " disruptions loaded");
 }
 
 void DisruptionDatabaseReader::finalize() {
     if (disruption && disruption->id() != "") {
-        make_and_apply_disruption(*disruption, pt_data, meta);
+        sink(std::move(disruption));
     }
 }
 
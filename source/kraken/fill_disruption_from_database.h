@@ -32,8 +32,15 @@ www.navitia.io
 #pragma once
 #include <string>
 #include <memory>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
 #include "type/pt_data.h"
 #include "pqxx/result.hxx"
+#include <boost/date_time/gregorian/gregorian.hpp>
 #include "type/chaos.pb.h"
 #include "make_disruption_from_chaos.h"
 
@@ -55,10 +62,70 @@ namespace navitia {
         FILL_NULLABLE(table_name, updated_at, uint64_t)
 
     void fill_disruption_from_database(const std::string& connection_string,
-            navitia::type::PT_Data& pt_data, navitia::type::MetaData &meta, const std::vector<std::string>& contributors);
+            navitia::type::PT_Data& pt_data, navitia::type::MetaData &meta, const std::vector<std::string>& contributors,
+            size_t nb_threads = 1);
+
+    /**
+     * Reads the disruptions of the chaos database in the background
+     *
+     * The rows are streamed through a cursor, page by page, and the
+     * disruptions of each page are built on nb_threads threads, while the
+     * data is still loading. apply() then applies them in the order of
+     * the query, on the thread owning the data.
+     */
+    class DisruptionDatabaseLoader {
+        struct Segment {
+            std::shared_ptr<const pqxx::result> rows;
+            size_t begin;
+            size_t end;
+        };
+        /// rows of whole disruptions, built by a single reader
+        struct Chunk {
+            std::vector<Segment> segments;
+            std::vector<std::unique_ptr<chaos::Disruption>> disruptions;
+            bool is_built = false;
+        };
+
+        std::mutex mutex;
+        std::condition_variable cond;
+        // a deque, its elements aren't moved by a push_back
+        std::deque<Chunk> chunks;
+        size_t next_to_build = 0;
+        bool is_read = false;
+        bool is_stopped = false;
+        std::exception_ptr error;
+        size_t nb_rows = 0;
+        std::vector<std::thread> threads;
+
+        void read(const std::string& connection_string,
+                  const boost::gregorian::date_period& production_date,
+                  const std::vector<std::string>& contributors);
+        void build();
+        void push_chunk(std::vector<Segment> segments);
+        void fail(std::exception_ptr e);
+
+    public:
+        static const size_t rows_per_fetch = 2000;
+
+        DisruptionDatabaseLoader(const std::string& connection_string,
+                                 const boost::gregorian::date_period& production_date,
+                                 const std::vector<std::string>& contributors,
+                                 size_t nb_threads);
+        ~DisruptionDatabaseLoader();
+
+        /// throws navitia::exception if the disruptions can't be read
+        void apply(type::PT_Data& pt_data, const type::MetaData& meta);
+    };
 
     struct DisruptionDatabaseReader {
-        DisruptionDatabaseReader(type::PT_Data& pt_data, const type::MetaData& meta) : pt_data(pt_data), meta(meta) {}
+        /// called with each complete disruption, in the order of the rows
+        using Sink = std::function<void(std::unique_ptr<chaos::Disruption>)>;
+
+        DisruptionDatabaseReader(type::PT_Data& pt_data, const type::MetaData& meta) :
+            sink([&pt_data, &meta](std::unique_ptr<chaos::Disruption> d) {
+                make_and_apply_disruption(*d, pt_data, meta);
+            }) {}
+        explicit DisruptionDatabaseReader(Sink sink) : sink(std::move(sink)) {}
 
         std::unique_ptr<chaos::Disruption> disruption = nullptr;
         chaos::Impact* impact = nullptr;
@@ -73,8 +140,7 @@ namespace navitia {
         std::set<std::string> message_ids;
         std::set<std::string> pt_object_ids;
         std::set<std::string> associate_objects_ids;
-        type::PT_Data& pt_data;
-        const type::MetaData& meta;
+        Sink sink;
 
         // This function and all others below are templated so they can be tested
         template<typename T>
@@ -138,7 +204,7 @@ namespace navitia {
         template<typename T>
         void fill_disruption(T const_it) {
             if (disruption) {
-                make_and_apply_disruption(*disruption, pt_data, meta);
+                sink(std::move(disruption));
             }
             disruption = std::make_unique<chaos::Disruption>();
             FILL_TIMESTAMPMIXIN(disruption)
@@ -38,6 +38,9 @@ www.navitia.io
 #include <iostream>
 #include "utils/init.h"
 #include "kraken_zmq.h"
+#include "kraken/worker_classes.h"
+#include "kraken/batch_runner.h"
+#include "kraken/queue_frontend.h"
 #include "utils/zmq.h"
 
 
@@ -74,28 +77,82 @@ int main(int argn, char** argv){
     zmq::context_t context(1);
     // Catch startup exceptions; without this, startup errors are on stdout
     std::string zmq_socket = conf.zmq_socket_path();
-    //TODO: try/catch
-    LoadBalancer lb(context);
+    // the requests are routed to a pool of workers by api
+    const auto worker_classes = navitia::kraken::parse_worker_classes(conf.worker_classes(),
+                                                                      conf.nb_threads(),
+                                                                      conf.max_queue());
+    const int nb_batch_threads = conf.nb_batch_threads();
+    // the workers are given the requests by a load balancer, or pop them from queues
+    std::unique_ptr<navitia::kraken::ClassLoadBalancer> lb;
+    std::unique_ptr<navitia::kraken::QueueFrontend> queue_frontend;
     try{
-        lb.bind(zmq_socket, "inproc://workers");
+        if (conf.use_queue_frontend()) {
+            LOG4CPLUS_INFO(logger, "requests dispatched by queues");
+            queue_frontend = std::make_unique<navitia::kraken::QueueFrontend>(context, worker_classes,
+                                                                              nb_batch_threads > 0);
+            queue_frontend->bind(zmq_socket);
+        } else {
+            lb = std::make_unique<navitia::kraken::ClassLoadBalancer>(context, worker_classes,
+                                                                      nb_batch_threads > 0);
+            lb->bind(zmq_socket);
+        }
     }catch(zmq::error_t& e){
         LOG4CPLUS_ERROR(logger, "zmq::socket_t::bind() failure: " << e.what());
         return 1;
     }
 
-    threads.create_thread(navitia::MaintenanceWorker(data_manager, conf));
+    auto metrics = std::make_shared<navitia::kraken::Metrics>();
+    threads.create_thread(navitia::MaintenanceWorker(data_manager, conf, metrics));
 
-    int nb_threads = conf.nb_threads();
-    // Launch pool of worker threads
-    LOG4CPLUS_INFO(logger, "starting workers threads");
-    for(int thread_nbr = 0; thread_nbr < nb_threads; ++thread_nbr) {
-        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf));
+    if (lb) { lb->set_metrics(*metrics); }
+    if (const auto metrics_socket = conf.metrics_socket()) {
+        LOG4CPLUS_INFO(logger, "metrics available on " << *metrics_socket);
+        threads.create_thread([&context, &data_manager, metrics, metrics_socket]() {
+            navitia::kraken::serve_metrics(context, *metrics, data_manager, *metrics_socket);
+        });
+    }
+
+    std::shared_ptr<navitia::kraken::ResponseCache> cache;
+    const auto cache_ttls = navitia::kraken::ResponseCache::parse_ttls(conf.cache_ttls());
+    if (! cache_ttls.empty()) {
+        LOG4CPLUS_INFO(logger, "responses cached for " << cache_ttls.size() << " apis");
+        cache = std::make_shared<navitia::kraken::ResponseCache>(cache_ttls, conf.cache_max_size(),
+                                                                 conf.cache_datetime_bucket());
+    }
+
+    // Launch the pools of worker threads
+    for (size_t i = 0; i < worker_classes.size(); ++i) {
+        const auto& worker_class = worker_classes[i];
+        LOG4CPLUS_INFO(logger, "starting " << worker_class.nb_threads << " "
+                       << worker_class.name << " workers threads");
+        for(int thread_nbr = 0; thread_nbr < worker_class.nb_threads; ++thread_nbr) {
+            if (queue_frontend) {
+                threads.create_thread(std::bind(&doQueueWork, std::ref(context), std::ref(data_manager), conf,
+                                                std::ref(queue_frontend->queue(i)),
+                                                queue_frontend->replies_socket_path(), cache, metrics));
+            } else {
+                threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf,
+                                                worker_class.socket_path(), cache, metrics));
+            }
+        }
+    }
+
+    std::unique_ptr<navitia::kraken::BatchRunner> batch_runner;
+    if (nb_batch_threads > 0) {
+        LOG4CPLUS_INFO(logger, "starting " << nb_batch_threads << " batch threads");
+        batch_runner = std::make_unique<navitia::kraken::BatchRunner>(data_manager, conf, nb_batch_threads);
+        threads.create_thread(std::bind(&navitia::kraken::BatchRunner::serve, batch_runner.get(),
+                                        std::ref(context), navitia::kraken::batches_socket_path()));
     }
 
     // Connect worker threads to client threads via a queue
     do{
         try{
-            lb.run();
+            if (queue_frontend) {
+                queue_frontend->run();
+            } else {
+                lb->run();
+            }
         }catch(const zmq::error_t&){}//lors d'un SIGHUP on restore la queue
     }while(true);
 }
@@ -36,6 +36,9 @@ www.navitia.io
 #include <utils/zmq.h>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include "kraken/configuration.h"
+#include "kraken/response_cache.h"
+#include "kraken/metrics.h"
+#include "kraken/queue_frontend.h"
 #include "type/meta_data.h"
 #include <log4cplus/ndc.h>
 
@@ -49,15 +52,113 @@ inline pbnavitia::Response make_internal_error(const std::exception& e) {
 }
 
 namespace pt = boost::posix_time;
+// the size is computed only once, SerializeToArray would walk the whole
+// response again to check it
+inline void serialize_reply(const pbnavitia::Response& response, zmq::message_t& reply) {
+    const int size = response.ByteSize();
+    reply.rebuild(size);
+    response.SerializeWithCachedSizesToArray(static_cast<google::protobuf::uint8*>(reply.data()));
+}
+
+/**
+ * Answer a serialized request, from the cache when possible
+ *
+ * pb_req is only given to keep its allocations from one request to the
+ * next.
+ */
+inline zmq::message_t handle_request(navitia::Worker& w,
+                                     DataManager<navitia::type::Data>& data_manager,
+                                     const zmq::message_t& request,
+                                     pbnavitia::Request& pb_req,
+                                     navitia::kraken::ResponseCache* cache,
+                                     navitia::kraken::Metrics::Recorder* recorder,
+                                     log4cplus::Logger& logger) {
+    pbnavitia::Response result;
+    pt::ptime start = pt::microsec_clock::universal_time();
+    pbnavitia::API api = pbnavitia::UNKNOWN_API;
+    boost::optional<navitia::kraken::ResponseCache::Key> cache_key;
+    if(!pb_req.ParseFromArray(request.data(), request.size())){
+        LOG4CPLUS_WARN(logger, "receive invalid protobuf");
+        result.mutable_error()->set_id(pbnavitia::Error::invalid_protobuf_request);
+    } else {
+        api = pb_req.requested_api();
+        log4cplus::NDCContextCreator ndc(pb_req.request_id());
+        if(api != pbnavitia::METADATAS){
+            LOG4CPLUS_DEBUG(logger, "receive request: " << pb_req.DebugString());
+        }
+        if (cache) {
+            cache_key = cache->make_key(pb_req, data_manager.get_data()->data_identifier);
+        }
+        if (cache_key) {
+            if (const auto cached = cache->get(*cache_key, start)) {
+                LOG4CPLUS_DEBUG(logger, "response found in the cache");
+                zmq::message_t reply(cached->size());
+                std::copy(cached->begin(), cached->end(), static_cast<char*>(reply.data()));
+                if (recorder) {
+                    recorder->record_request(api, pt::microsec_clock::universal_time() - start,
+                                             request.size(), cached->size(), false);
+                }
+                return reply;
+            }
+        }
+        try {
+            auto response = w.dispatch(pb_req);
+            result.Swap(&response);
+            if(api != pbnavitia::METADATAS){
+                LOG4CPLUS_TRACE(logger, "response: " << result.DebugString());
+            }
+        } catch (const navitia::recoverable_exception& e) {
+            //on a recoverable an internal server error is returned
+            LOG4CPLUS_ERROR(logger, "internal server error: " << e.what());
+            LOG4CPLUS_ERROR(logger, "on query: " << pb_req.DebugString());
+            LOG4CPLUS_ERROR(logger, "backtrace: " << e.backtrace());
+            result = make_internal_error(e);
+        }
+        if (! data_manager.get_data()->loaded){
+            result.set_publication_date(-1);
+        } else {
+            result.set_publication_date(navitia::to_posix_timestamp(data_manager.get_data()->meta->publication_date));
+        }
+    }
+    zmq::message_t reply;
+    try{
+        serialize_reply(result, reply);
+    }catch(const google::protobuf::FatalException& e){
+        LOG4CPLUS_ERROR(logger, "failure during serialization: " << e.what());
+        result = make_internal_error(e);
+        serialize_reply(result, reply);
+    }
+    // the internal errors might not happen on the next call
+    if (cache_key && ! (result.has_error() && result.error().id() == pbnavitia::Error::internal_error)) {
+        cache->put(*cache_key, std::string(static_cast<const char*>(reply.data()), reply.size()),
+                   pt::microsec_clock::universal_time());
+    }
+
+    const auto duration = pt::microsec_clock::universal_time() - start;
+    if (recorder) {
+        recorder->record_request(api, duration, request.size(), reply.size(), result.has_error());
+    }
+    if(api != pbnavitia::METADATAS){
+        LOG4CPLUS_DEBUG(logger, "processing time : " << duration.total_milliseconds());
+    }
+    return reply;
+}
+
 inline void doWork(zmq::context_t& context,
                    DataManager<navitia::type::Data>& data_manager,
-                   navitia::kraken::Configuration conf) {
+                   navitia::kraken::Configuration conf,
+                   const std::string& workers_socket,
+                   std::shared_ptr<navitia::kraken::ResponseCache> cache,
+                   std::shared_ptr<navitia::kraken::Metrics> metrics) {
     auto logger = log4cplus::Logger::getInstance("worker");
+    auto* recorder = metrics ? &metrics->new_recorder() : nullptr;
 
     zmq::socket_t socket (context, ZMQ_REQ);
-    socket.connect("inproc://workers");
+    socket.connect(workers_socket.c_str());
     bool run = true;
     navitia::Worker w(data_manager, conf);
+    // reused between the requests: parsing into it keeps its allocations
+    pbnavitia::Request pb_req;
     z_send(socket, "READY");
     while(run) {
         std::string address = z_recv(socket);
@@ -74,54 +175,34 @@ inline void doWork(zmq::context_t& context,
             continue;
         }
 
-        pbnavitia::Request pb_req;
-        pbnavitia::Response result;
-        pt::ptime start = pt::microsec_clock::universal_time();
-        pbnavitia::API api = pbnavitia::UNKNOWN_API;
-        if(!pb_req.ParseFromArray(request.data(), request.size())){
-            LOG4CPLUS_WARN(logger, "receive invalid protobuf");
-            result.mutable_error()->set_id(pbnavitia::Error::invalid_protobuf_request);
-        } else {
-            api = pb_req.requested_api();
-            log4cplus::NDCContextCreator ndc(pb_req.request_id());
-            if(api != pbnavitia::METADATAS){
-                LOG4CPLUS_DEBUG(logger, "receive request: " << pb_req.DebugString());
-            }
-            try {
-                result = w.dispatch(pb_req);
-                if(api != pbnavitia::METADATAS){
-                    LOG4CPLUS_TRACE(logger, "response: " << result.DebugString());
-                }
-            } catch (const navitia::recoverable_exception& e) {
-                //on a recoverable an internal server error is returned
-                LOG4CPLUS_ERROR(logger, "internal server error: " << e.what());
-                LOG4CPLUS_ERROR(logger, "on query: " << pb_req.DebugString());
-                LOG4CPLUS_ERROR(logger, "backtrace: " << e.backtrace());
-                result = make_internal_error(e);
-            }
-            if (! data_manager.get_data()->loaded){
-                result.set_publication_date(-1);
-            } else {
-                result.set_publication_date(navitia::to_posix_timestamp(data_manager.get_data()->meta->publication_date));
-            }
-        }
-        zmq::message_t reply(result.ByteSize());
-        try{
-            result.SerializeToArray(reply.data(), result.ByteSize());
-        }catch(const google::protobuf::FatalException& e){
-            LOG4CPLUS_ERROR(logger, "failure during serialization: " << e.what());
-            result = make_internal_error(e);
-            reply.rebuild(result.ByteSize());
-            result.SerializeToArray(reply.data(), result.ByteSize());
-
-        }
+        auto reply = handle_request(w, data_manager, request, pb_req, cache.get(), recorder, logger);
         z_send(socket, address, ZMQ_SNDMORE);
         z_send(socket, "", ZMQ_SNDMORE);
         socket.send(reply);
+    }
+}
 
-        if(api != pbnavitia::METADATAS){
-            LOG4CPLUS_DEBUG(logger, "processing time : "
-                            << (pt::microsec_clock::universal_time() - start).total_milliseconds());
+/// a worker of the QueueFrontend, popping the requests of its class queue
+inline void doQueueWork(zmq::context_t& context,
+                        DataManager<navitia::type::Data>& data_manager,
+                        navitia::kraken::Configuration conf,
+                        navitia::kraken::RequestQueue& queue,
+                        const std::string& replies_socket,
+                        std::shared_ptr<navitia::kraken::ResponseCache> cache,
+                        std::shared_ptr<navitia::kraken::Metrics> metrics) {
+    auto logger = log4cplus::Logger::getInstance("worker");
+    auto* recorder = metrics ? &metrics->new_recorder() : nullptr;
+
+    zmq::socket_t replies(context, ZMQ_PUSH);
+    replies.connect(replies_socket.c_str());
+    navitia::Worker w(data_manager, conf);
+    pbnavitia::Request pb_req;
+    while (true) {
+        auto request = queue.pop();
+        if (recorder) {
+            recorder->record_queue_wait(request.api, pt::microsec_clock::universal_time() - request.received_at);
         }
+        auto reply = handle_request(w, data_manager, request.request, pb_req, cache.get(), recorder, logger);
+        navitia::kraken::send_reply(replies, request.client, reply);
     }
 }
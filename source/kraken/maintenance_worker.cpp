@@ -33,14 +33,20 @@ www.navitia.io
 #include "make_disruption_from_chaos.h"
 #include "apply_disruption.h"
 #include "realtime.h"
+#include "rt_batch.h"
+#include "warm_up.h"
+#include "type/memory_report.h"
 #include "type/task.pb.h"
 #include "type/pt_data.h"
+#include "type/datetime.h"
 #include <boost/algorithm/string/join.hpp>
 #include <boost/optional.hpp>
 #include <sys/stat.h>
 #include <signal.h>
 #include <SimpleAmqpClient/Envelope.h>
+#include <algorithm>
 #include <chrono>
+#include <cstdio>
 #include <thread>
 #include "utils/get_hostname.h"
 
@@ -56,15 +62,86 @@ void MaintenanceWorker::load(){
     const std::string database = conf.databases_path();
     auto chaos_database = conf.chaos_database();
     auto contributors = conf.rt_topics();
+    std::function<void(const boost::shared_ptr<const type::Data>&)> warm_up;
+    const auto requests_file = conf.warm_up_requests();
+    if (requests_file) {
+        warm_up = [this, requests_file](const boost::shared_ptr<const type::Data>& data) {
+            try {
+                const auto requests = kraken::read_request_log(*requests_file);
+                LOG4CPLUS_INFO(logger, "warming up the data with " << requests.size() << " requests");
+                const auto stats = kraken::warm_up(data, conf, requests, conf.nb_threads(),
+                                                   pt::seconds(conf.warm_up_budget()));
+                LOG4CPLUS_INFO(logger, "warm up done in " << stats.duration.total_milliseconds() << "ms: "
+                               << stats.nb_requests << " requests replayed, "
+                               << stats.nb_errors << " errors, "
+                               << stats.nb_skipped << " skipped for lack of time");
+            } catch (const std::exception& e) {
+                // a cold start is better than no start
+                LOG4CPLUS_WARN(logger, "no warm up: " << e.what());
+            }
+        };
+    }
     LOG4CPLUS_INFO(logger, "Loading database from file: " + database);
-    if(this->data_manager.load(database, chaos_database, contributors)){
+    if(this->data_manager.load(database, chaos_database, contributors, warm_up,
+                                navitia::seconds(conf.transfer_closure()), conf.nb_chaos_threads())){
         auto data = data_manager.get_data();
         data->is_realtime_loaded = false;
         data->meta->instance_name = conf.instance_name();
+        // the report walks the whole data, it is also given on demand by the metrics socket
+        LOG4CPLUS_DEBUG(logger, "memory usage of the data:\n" << type::memory_report(*data));
+        if (use_rt_snapshot) {
+            // only once: a new data gets its realtime from kirin
+            use_rt_snapshot = false;
+            LOG4CPLUS_INFO(logger, "reapplying the " << rt_snapshot.size() << " realtime entities of the snapshot");
+            apply_rt_messages(rt_snapshot.messages(), true);
+            data_manager.get_data()->is_realtime_loaded = true;
+        } else if (const auto path = conf.rt_snapshot()) {
+            // the realtime of the previous data is obsolete, the new one is reloaded from kirin
+            rt_snapshot.clear();
+            rt_snapshot_outdated = false;
+            std::remove(path->c_str());
+            ack_rt_unacked();
+        }
     }
     load_realtime();
 }
 
+void MaintenanceWorker::read_rt_snapshot(){
+    const auto path = conf.rt_snapshot();
+    if (! path || ! conf.is_realtime_enabled()) {
+        return;
+    }
+    const auto snapshot_time = rt_snapshot_time(*path);
+    if (snapshot_time.is_not_a_date_time()) {
+        LOG4CPLUS_INFO(logger, "no realtime snapshot " << *path);
+        return;
+    }
+    if (pt::second_clock::universal_time() - snapshot_time > pt::seconds(conf.rt_snapshot_max_age())) {
+        LOG4CPLUS_WARN(logger, "realtime snapshot of " << snapshot_time << " too old, ignored");
+        return;
+    }
+    try {
+        rt_snapshot.load(*path);
+    } catch (const navitia::exception& e) {
+        LOG4CPLUS_WARN(logger, "realtime snapshot ignored: " << e.what());
+        return;
+    }
+    const auto nb_pruned = rt_snapshot.prune(pt::microsec_clock::universal_time());
+    LOG4CPLUS_INFO(logger, "realtime snapshot of " << snapshot_time << ": " << rt_snapshot.size()
+                   << " entities, " << nb_pruned << " expired");
+    auto snapshot_topics = rt_snapshot.topics();
+    auto topics = conf.rt_topics();
+    std::sort(snapshot_topics.begin(), snapshot_topics.end());
+    std::sort(topics.begin(), topics.end());
+    if (snapshot_topics != topics) {
+        // the queue bindings change, it can't be kept to catch up the messages since the snapshot
+        LOG4CPLUS_WARN(logger, "realtime snapshot of other topics, ignored");
+        rt_snapshot.clear();
+        return;
+    }
+    use_rt_snapshot = true;
+}
+
 
 void MaintenanceWorker::load_realtime(){
     if(!conf.is_realtime_enabled()){
@@ -157,58 +234,121 @@ void MaintenanceWorker::handle_task_in_batch(const std::vector<AmqpClient::Envel
 
 
 void MaintenanceWorker::handle_rt_in_batch(const std::vector<AmqpClient::Envelope::ptr_t>& envelopes){
-    boost::shared_ptr<nt::Data> data{};
+    LOG4CPLUS_DEBUG(logger, envelopes.size() << " realtime messages received");
+    std::vector<std::string> bodies;
+    bodies.reserve(envelopes.size());
     for (auto& envelope: envelopes) {
-        LOG4CPLUS_DEBUG(logger, "realtime info received!");
         assert(envelope);
-        transit_realtime::FeedMessage feed_message;
-        if(! feed_message.ParseFromString(envelope->Message()->Body())){
-            LOG4CPLUS_WARN(logger, "protobuf not valid!");
-            return;
+        bodies.push_back(envelope->Message()->Body());
+    }
+    apply_rt_messages(bodies, false);
+}
+
+void MaintenanceWorker::apply_rt_messages(const std::vector<std::string>& bodies, bool from_snapshot){
+    const auto begin = pt::microsec_clock::universal_time();
+    const auto batch = parse_rt_batch(bodies, conf.nb_threads());
+    if (batch.nb_invalid) {
+        LOG4CPLUS_WARN(logger, batch.nb_invalid << " protobuf not valid!");
+    }
+
+    boost::shared_ptr<nt::Data> data{};
+    // the cloned data, kept alive to rebuild only the modified part of raptor
+    boost::shared_ptr<const nt::Data> previous{};
+    for (const auto& update: batch.updates) {
+        const auto& entity = *update.entity;
+        LOG4CPLUS_TRACE(logger, "received entity: " << entity.DebugString());
+        if (!data) {
+            previous = data_manager.get_data();
+            data = data_manager.get_data_clone();
+            data->last_rt_data_loaded = pt::microsec_clock::universal_time();
         }
-        LOG4CPLUS_TRACE(logger, "received entity: " << feed_message.DebugString());
-        for(const auto& entity: feed_message.entity()){
-            if (!data) {
-                data = data_manager.get_data_clone();
-                data->last_rt_data_loaded = pt::microsec_clock::universal_time();
-            }
-            if (entity.is_deleted()) {
-                LOG4CPLUS_DEBUG(logger, "deletion of disruption " << entity.id());
-                delete_disruption(entity.id(), *data->pt_data, *data->meta);
-            } else if(entity.HasExtension(chaos::disruption)) {
-                LOG4CPLUS_DEBUG(logger, "add/update of disruption " << entity.id());
-                make_and_apply_disruption(entity.GetExtension(chaos::disruption), *data->pt_data, *data->meta);
-            } else if(entity.has_trip_update()) {
-                LOG4CPLUS_DEBUG(logger, "RT trip update" << entity.id());
-                handle_realtime(entity.id(),
-                                navitia::from_posix_timestamp(feed_message.header().timestamp()),
-                                entity.trip_update(),
-                                *data);
-            } else {
-                LOG4CPLUS_WARN(logger, "unsupported gtfs rt feed");
-            }
+        if (entity.is_deleted()) {
+            LOG4CPLUS_DEBUG(logger, "deletion of disruption " << entity.id());
+            delete_disruption(entity.id(), *data->pt_data, *data->meta);
+        } else if(entity.HasExtension(chaos::disruption)) {
+            LOG4CPLUS_DEBUG(logger, "add/update of disruption " << entity.id());
+            make_and_apply_disruption(entity.GetExtension(chaos::disruption), *data->pt_data, *data->meta);
+        } else if(entity.has_trip_update()) {
+            LOG4CPLUS_DEBUG(logger, "RT trip update" << entity.id());
+            handle_realtime(entity.id(), update.timestamp, entity.trip_update(), *data);
+        } else {
+            LOG4CPLUS_WARN(logger, "unsupported gtfs rt feed");
         }
     }
+    LOG4CPLUS_INFO(logger, "realtime batch: " << bodies.size() - batch.nb_invalid << " messages parsed, "
+                   << batch.nb_entities << " entities, " << batch.nb_coalesced << " coalesced away, "
+                   << batch.updates.size() << " applied");
     if (data) {
+        const auto applied = pt::microsec_clock::universal_time();
         LOG4CPLUS_INFO(logger, "rebuilding data raptor");
-        data->build_raptor(conf.raptor_cache_size());
+        data->build_raptor(*previous, conf.raptor_cache_size());
         data_manager.set_data(std::move(data));
+        const auto visible = pt::microsec_clock::universal_time();
         LOG4CPLUS_INFO(logger, "data updated");
+        if (from_snapshot) {
+            return;
+        }
+        if (conf.rt_snapshot()) {
+            // saved later by listen_rabbitmq, not to write it at each batch
+            rt_snapshot.add(batch);
+            rt_snapshot_outdated = true;
+        }
+
+        rt_scheduler.record_batch(batch.updates.size(), applied - begin, visible - applied);
+        if (metrics) {
+            auto& rt_metrics = metrics->realtime;
+            rt_metrics.nb_batches.fetch_add(1, std::memory_order_relaxed);
+            rt_metrics.nb_messages.fetch_add(bodies.size(), std::memory_order_relaxed);
+            rt_metrics.apply.add((applied - begin).total_microseconds());
+            rt_metrics.rebuild.add((visible - applied).total_microseconds());
+            const auto no_timestamp = navitia::from_posix_timestamp(0);
+            for (const auto& update: batch.updates) {
+                if (update.timestamp == no_timestamp) { continue; }
+                rt_metrics.freshness.add(std::max<int64_t>(0, (visible - update.timestamp).total_microseconds()));
+            }
+        }
+    }
+}
+
+void MaintenanceWorker::save_rt_snapshot(const std::string& path){
+    const auto now = pt::microsec_clock::universal_time();
+    const auto nb_pruned = rt_snapshot.prune(now);
+    try {
+        rt_snapshot.save(path, conf.rt_topics());
+        LOG4CPLUS_DEBUG(logger, "realtime snapshot saved: " << rt_snapshot.size() << " entities, "
+                        << nb_pruned << " expired");
+    } catch (const navitia::exception& e) {
+        // an older snapshot would miss the messages acked below
+        LOG4CPLUS_WARN(logger, "realtime snapshot not saved, removed: " << e.what());
+        std::remove(path.c_str());
     }
+    rt_snapshot_outdated = false;
+    next_rt_snapshot_save = now + pt::seconds(conf.rt_snapshot_interval());
+    ack_rt_unacked();
+}
+
+void MaintenanceWorker::ack_rt_unacked(){
+    for (const auto& envelope: rt_unacked) {
+        // our SimpleAmqpClient has no multiple ack
+        channel->BasicAck(envelope);
+    }
+    rt_unacked.clear();
 }
 
 std::vector<AmqpClient::Envelope::ptr_t>
 MaintenanceWorker::consume_in_batch(const std::string& consume_tag,
         size_t max_nb,
         size_t timeout_ms,
-        bool no_ack){
+        bool ack_on_receipt,
+        const pt::time_duration& window){
     assert(consume_tag != "");
     assert(max_nb);
 
     std::vector<AmqpClient::Envelope::ptr_t> envelopes;
     envelopes.reserve(max_nb);
     size_t consumed_nb = 0;
-    while(consumed_nb < max_nb) {
+    pt::ptime deadline(pt::pos_infin);
+    while(consumed_nb < max_nb && pt::microsec_clock::universal_time() < deadline) {
         AmqpClient::Envelope::ptr_t envelope{};
 
         /* !
@@ -219,8 +359,11 @@ MaintenanceWorker::consume_in_batch(const std::string& consume_tag,
         if (queue_is_empty) break;
 
         if (envelope) {
+            if (envelopes.empty() && ! window.is_pos_infinity()) {
+                deadline = pt::microsec_clock::universal_time() + window;
+            }
             envelopes.push_back(envelope);
-            if (! no_ack) channel->BasicAck(envelope);
+            if (ack_on_receipt) channel->BasicAck(envelope);
             ++ consumed_nb;
         }
     }
@@ -234,7 +377,15 @@ void MaintenanceWorker::listen_rabbitmq(){
     bool no_local = true;
     bool no_ack = false;
     std::string task_tag = this->channel->BasicConsume(this->queue_name_task, "", no_local, no_ack);
-    std::string rt_tag = this->channel->BasicConsume(this->queue_name_rt, "", no_local, no_ack);
+    // the realtime messages are acked once applied, a crash or a reconnection gives them again.
+    // The broker delivers at most a batch of unacked messages in advance.
+    // With a snapshot, they are acked once it is saved, and several batches can wait for it.
+    bool exclusive = true;
+    const auto snapshot_path = conf.rt_snapshot();
+    rt_prefetch = std::min<size_t>(size_t(conf.rt_max_batch_size()) * (snapshot_path ? 10 : 1), 65535);
+    rt_unacked.clear();
+    std::string rt_tag = this->channel->BasicConsume(this->queue_name_rt, "", no_local, no_ack, exclusive,
+                                                     uint16_t(rt_prefetch));
 
     LOG4CPLUS_INFO(logger, "start event loop");
     data_manager.get_data()->is_connected_to_rabbitmq = true;
@@ -247,19 +398,27 @@ void MaintenanceWorker::listen_rabbitmq(){
         }
         size_t timeout_ms = conf.broker_timeout();
 
-        // Arbitrary Number: we suppose that disruptions can be handled very quickly so that,
-        // in theory, we can handle a batch of 5000 disruptions in one time very quickly too.
-        size_t max_batch_nb = 5000;
-
-        auto rt_envelopes = consume_in_batch(rt_tag, max_batch_nb, timeout_ms, no_ack);
+        // the size and the collection time of the batch depend on the cost of the last ones
+        auto rt_envelopes = consume_in_batch(rt_tag, rt_scheduler.batch_size(), timeout_ms, false,
+                                             rt_scheduler.collect_window());
         handle_rt_in_batch(rt_envelopes);
+        rt_unacked.insert(rt_unacked.end(), rt_envelopes.begin(), rt_envelopes.end());
+        if (! snapshot_path || ! rt_snapshot_outdated) {
+            ack_rt_unacked();
+        } else if (now >= next_rt_snapshot_save || rt_unacked.size() >= rt_prefetch) {
+            // the broker stops delivering once the prefetch is unacked
+            save_rt_snapshot(*snapshot_path);
+        }
 
-        auto task_envelopes = consume_in_batch(task_tag, 1, timeout_ms, no_ack);
+        auto task_envelopes = consume_in_batch(task_tag, 1, timeout_ms, true);
         handle_task_in_batch(task_envelopes);
 
         // Since consume_in_batch is non blocking, we don't want that the worker loops for nothing, when the
-        // queue is empty.
-        std::this_thread::sleep_for(std::chrono::seconds(conf.broker_sleeptime()));
+        // queues are empty. When messages are waiting, we go on at once.
+        if (rt_envelopes.empty() && task_envelopes.empty()) {
+            const auto sleep = rt_scheduler.idle_sleep(pt::seconds(conf.broker_sleeptime()));
+            std::this_thread::sleep_for(std::chrono::microseconds(sleep.total_microseconds()));
+        }
     }
 }
 
@@ -285,9 +444,24 @@ void MaintenanceWorker::init_rabbitmq(){
         try{
             channel->DeleteQueue(queue_name_task);
         }catch(const std::runtime_error&){}
-        try{
-            channel->DeleteQueue(queue_name_rt);
-        }catch(const std::runtime_error&){}
+        // with a snapshot, the messages received since it was saved are still in the queue
+        bool keep_rt_queue = false;
+        if (use_rt_snapshot) {
+            try{
+                //                                 name, passive, durable, exclusive, auto_delete
+                channel->DeclareQueue(queue_name_rt, true, true, false, false);
+                keep_rt_queue = true;
+            }catch(const std::runtime_error&){
+                LOG4CPLUS_WARN(logger, "no queue " << queue_name_rt << " to catch up, realtime snapshot ignored");
+                use_rt_snapshot = false;
+                rt_snapshot.clear();
+            }
+        }
+        if (! keep_rt_queue) {
+            try{
+                channel->DeleteQueue(queue_name_rt);
+            }catch(const std::runtime_error&){}
+        }
 
         this->channel->DeclareExchange(exchange_name, "topic", false, true, false);
 
@@ -309,16 +483,22 @@ void MaintenanceWorker::init_rabbitmq(){
     LOG4CPLUS_DEBUG(logger, "connected to rabbitmq");
 }
 
-MaintenanceWorker::MaintenanceWorker(DataManager<type::Data>& data_manager, kraken::Configuration conf) :
+MaintenanceWorker::MaintenanceWorker(DataManager<type::Data>& data_manager, kraken::Configuration conf,
+                                     std::shared_ptr<kraken::Metrics> metrics) :
         data_manager(data_manager),
         logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("background"))),
         conf(conf),
-        next_try_realtime_loading(pt::microsec_clock::universal_time()){
+        next_try_realtime_loading(pt::microsec_clock::universal_time()),
+        metrics(metrics),
+        rt_scheduler(pt::milliseconds(conf.rt_latency_target()), conf.rt_max_batch_size()){
+    read_rt_snapshot();
     try{
         this->init_rabbitmq();
     }catch(const std::runtime_error& ex){
         LOG4CPLUS_ERROR(logger, "Connection to rabbitmq failed: " << ex.what());
         data_manager.get_data()->is_connected_to_rabbitmq = false;
+        // without its queue, the messages since the snapshot would be lost
+        use_rt_snapshot = false;
     }
     try{
         load();
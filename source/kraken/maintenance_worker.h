@@ -34,6 +34,9 @@ www.navitia.io
 #include "type/data.h"
 #include "kraken/data_manager.h"
 #include "kraken/configuration.h"
+#include "kraken/metrics.h"
+#include "kraken/rt_scheduler.h"
+#include "kraken/rt_snapshot.h"
 
 #include <memory>
 
@@ -52,12 +55,29 @@ class MaintenanceWorker{
         std::string queue_name_rt;
 
         boost::posix_time::ptime next_try_realtime_loading;
+        std::shared_ptr<kraken::Metrics> metrics;
+        kraken::RtScheduler rt_scheduler;
+        /// the realtime applied on the current data
+        RtSnapshot rt_snapshot;
+        /// the snapshot read at startup is reapplied instead of asking kirin for a full reload
+        bool use_rt_snapshot = false;
+        /// realtime applied since the last save of the snapshot
+        bool rt_snapshot_outdated = false;
+        boost::posix_time::ptime next_rt_snapshot_save = boost::posix_time::min_date_time;
+        /// with a snapshot, the realtime messages are acked once it is saved
+        std::vector<AmqpClient::Envelope::ptr_t> rt_unacked;
+        size_t rt_prefetch = 0;
 
         void init_rabbitmq();
         void listen_rabbitmq();
 
         void handle_task_in_batch(const std::vector<AmqpClient::Envelope::ptr_t>& envelopes);
         void handle_rt_in_batch(const std::vector<AmqpClient::Envelope::ptr_t>& envelopes);
+        void apply_rt_messages(const std::vector<std::string>& bodies, bool from_snapshot);
+
+        void read_rt_snapshot();
+        void save_rt_snapshot(const std::string& path);
+        void ack_rt_unacked();
 
         void load_realtime();
 
@@ -65,21 +85,27 @@ class MaintenanceWorker{
          * This function will consume message in batch. It calls
          * AmqpClient::Channel::BasicConsumeMessage(const std::string&, Envelope::ptr_t&, int) to try
          * to get a message within a given timeout, if BasicConsumeMessage get a message with success,
-         * the message will be push back and acked. This function will loop until it get max_nb messages or
+         * the message will be push back, and acked if ack_on_receipt. This function will loop until it get max_nb messages or
          * the queue is "empty" (the emptiness is tested by the timeout, if the network doesn't work well,
          * it'd be better to set a larger timeout).
          *
          * Since BasicConsumeMessage is non-blocking, this function is non-blocking neither.
+         *
+         * The batch is also closed when window is elapsed since its first message, so that a
+         * steady trickle of messages doesn't delay them indefinitely.
          * */
         std::vector<AmqpClient::Envelope::ptr_t>
         consume_in_batch(const std::string& consume_tag,
                 size_t max_nb,
                 size_t timeout_ms,
-                bool no_ack);
+                bool ack_on_receipt,
+                const boost::posix_time::time_duration& window =
+                    boost::posix_time::time_duration(boost::posix_time::pos_infin));
         bool is_initialized = false;
 
     public:
-        MaintenanceWorker(DataManager<type::Data>& data_manager, const kraken::Configuration conf);
+        MaintenanceWorker(DataManager<type::Data>& data_manager, const kraken::Configuration conf,
+                          std::shared_ptr<kraken::Metrics> metrics = {});
 
         bool load_and_switch();
 
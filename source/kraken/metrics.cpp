@@ -0,0 +1,179 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "metrics.h"
+#include "type/memory_report.h"
+#include "type/tracing.h"
+#include "utils/zmq.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+namespace navitia { namespace kraken {
+
+size_t Histogram::bucket(uint64_t value) {
+    if (value < nb_sub_buckets) { return value; }
+    const size_t msb = 63 - __builtin_clzll(value);
+    // the 4 bits after the most significant one give the sub bucket
+    const size_t res = (msb - 3) * nb_sub_buckets + ((value >> (msb - 4)) - nb_sub_buckets);
+    return std::min(res, nb_buckets - 1);
+}
+
+uint64_t Histogram::bucket_value(size_t bucket) {
+    if (bucket < nb_sub_buckets) { return bucket; }
+    const size_t magnitude = bucket / nb_sub_buckets;
+    return (nb_sub_buckets + bucket % nb_sub_buckets) << (magnitude - 1);
+}
+
+void Histogram::merge_into(std::vector<uint64_t>& merged_counts) const {
+    merged_counts.resize(nb_buckets, 0);
+    for (size_t i = 0; i < nb_buckets; ++i) {
+        merged_counts[i] += counts[i].load(std::memory_order_relaxed);
+    }
+}
+
+uint64_t percentile(const std::vector<uint64_t>& counts, double q) {
+    uint64_t total = 0;
+    for (const auto count: counts) { total += count; }
+    if (total == 0) { return 0; }
+    const uint64_t rank = std::max<uint64_t>(1, uint64_t(std::ceil(q * total)));
+    uint64_t nb_seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        nb_seen += counts[i];
+        if (nb_seen >= rank) { return Histogram::bucket_value(i); }
+    }
+    return Histogram::bucket_value(counts.size() - 1);
+}
+
+Metrics::Recorder::Recorder(): apis(new ApiMetrics[pbnavitia::API_ARRAYSIZE]) {}
+
+ApiMetrics* Metrics::Recorder::get(pbnavitia::API api) {
+    if (api < 0 || api >= pbnavitia::API_ARRAYSIZE) { return nullptr; }
+    return &apis[api];
+}
+
+void Metrics::Recorder::record_request(pbnavitia::API api,
+                                       const boost::posix_time::time_duration& duration,
+                                       size_t request_size,
+                                       size_t response_size,
+                                       bool is_error) {
+    auto* metrics = get(api);
+    if (! metrics) { return; }
+    metrics->latency.add(std::max<int64_t>(0, duration.total_microseconds()));
+    metrics->nb_requests.fetch_add(1, std::memory_order_relaxed);
+    if (is_error) { metrics->nb_errors.fetch_add(1, std::memory_order_relaxed); }
+    metrics->request_bytes.fetch_add(request_size, std::memory_order_relaxed);
+    metrics->response_bytes.fetch_add(response_size, std::memory_order_relaxed);
+}
+
+void Metrics::Recorder::record_queue_wait(pbnavitia::API api, const boost::posix_time::time_duration& wait) {
+    if (auto* metrics = get(api)) {
+        metrics->queue_wait.add(std::max<int64_t>(0, wait.total_microseconds()));
+    }
+}
+
+Metrics::Recorder& Metrics::new_recorder() {
+    std::lock_guard<std::mutex> lock(mutex);
+    recorders.push_back(std::make_unique<Recorder>());
+    return *recorders.back();
+}
+
+std::string Metrics::dump() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::ostringstream os;
+    os << "api nb_requests nb_errors request_bytes response_bytes"
+       << " latency_us(p50 p90 p99 p999 max) queue_wait_us(p50 p99 max)\n";
+    for (int api = 0; api < pbnavitia::API_ARRAYSIZE; ++api) {
+        if (! pbnavitia::API_IsValid(api)) { continue; }
+        uint64_t nb_requests = 0, nb_errors = 0, request_bytes = 0, response_bytes = 0;
+        std::vector<uint64_t> latency, queue_wait;
+        for (const auto& recorder: recorders) {
+            const auto& metrics = recorder->apis[api];
+            nb_requests += metrics.nb_requests.load(std::memory_order_relaxed);
+            nb_errors += metrics.nb_errors.load(std::memory_order_relaxed);
+            request_bytes += metrics.request_bytes.load(std::memory_order_relaxed);
+            response_bytes += metrics.response_bytes.load(std::memory_order_relaxed);
+            metrics.latency.merge_into(latency);
+            metrics.queue_wait.merge_into(queue_wait);
+        }
+        if (nb_requests == 0) { continue; }
+        os << pbnavitia::API_Name(pbnavitia::API(api))
+           << " " << nb_requests << " " << nb_errors << " " << request_bytes << " " << response_bytes
+           << " " << percentile(latency, 0.5) << " " << percentile(latency, 0.9)
+           << " " << percentile(latency, 0.99) << " " << percentile(latency, 0.999)
+           << " " << percentile(latency, 1)
+           << " " << percentile(queue_wait, 0.5) << " " << percentile(queue_wait, 0.99)
+           << " " << percentile(queue_wait, 1) << "\n";
+    }
+    const auto nb_batches = realtime.nb_batches.load(std::memory_order_relaxed);
+    if (nb_batches) {
+        std::vector<uint64_t> freshness, apply, rebuild;
+        realtime.freshness.merge_into(freshness);
+        realtime.apply.merge_into(apply);
+        realtime.rebuild.merge_into(rebuild);
+        os << "realtime nb_batches nb_messages freshness_us(p50 p99 max) apply_us(p50 max) rebuild_us(p50 max)\n"
+           << "realtime " << nb_batches << " " << realtime.nb_messages.load(std::memory_order_relaxed)
+           << " " << percentile(freshness, 0.5) << " " << percentile(freshness, 0.99)
+           << " " << percentile(freshness, 1)
+           << " " << percentile(apply, 0.5) << " " << percentile(apply, 1)
+           << " " << percentile(rebuild, 0.5) << " " << percentile(rebuild, 1) << "\n";
+    }
+    return os.str();
+}
+
+void serve_metrics(zmq::context_t& context,
+                   const Metrics& metrics,
+                   const DataManager<type::Data>& data_manager,
+                   const std::string& socket_path) {
+    zmq::socket_t socket(context, ZMQ_REP);
+    socket.bind(socket_path.c_str());
+    while (true) {
+        std::string request;
+        try {
+            request = z_recv(socket);
+        } catch (const zmq::error_t&) {
+            // interrupted by a signal
+            continue;
+        }
+        if (request == "memory") {
+            std::ostringstream os;
+            os << type::memory_report(*data_manager.get_data());
+            z_send(socket, os.str());
+        } else if (request == "trace") {
+            std::ostringstream os;
+            tracing::write_chrome_trace(os);
+            z_send(socket, os.str());
+        } else {
+            z_send(socket, metrics.dump());
+        }
+    }
+}
+
+}} // namespace navitia::kraken
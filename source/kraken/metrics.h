@@ -0,0 +1,141 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/request.pb.h"
+#include "type/data.h"
+#include "kraken/data_manager.h"
+#include <zmq.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace navitia { namespace kraken {
+
+/**
+ * Histogram of durations in microseconds, in the way of HdrHistogram
+ *
+ * The buckets are linear in each power of 2, thus the error on a value
+ * is at most 1/16th. Only one thread adds values, any thread can read
+ * them, nothing is locked.
+ */
+class Histogram {
+public:
+    static const size_t nb_sub_buckets = 16;
+    /// up to 2^32 microseconds, i.e. more than an hour
+    static const size_t nb_buckets = 29 * nb_sub_buckets;
+
+    static size_t bucket(uint64_t value);
+    /// the lowest value of the bucket
+    static uint64_t bucket_value(size_t bucket);
+
+    void add(uint64_t value) { counts[bucket(value)].fetch_add(1, std::memory_order_relaxed); }
+    void merge_into(std::vector<uint64_t>& merged_counts) const;
+
+private:
+    std::array<std::atomic<uint64_t>, nb_buckets> counts{};
+};
+
+/// the value at quantile q (between 0 and 1) of merged counts, 0 if empty
+uint64_t percentile(const std::vector<uint64_t>& counts, double q);
+
+struct ApiMetrics {
+    Histogram latency;
+    /// time spent in the queue of the load balancer
+    Histogram queue_wait;
+    std::atomic<uint64_t> nb_requests{0};
+    std::atomic<uint64_t> nb_errors{0};
+    std::atomic<uint64_t> request_bytes{0};
+    std::atomic<uint64_t> response_bytes{0};
+};
+
+/// the realtime ingestion, recorded by the maintenance worker only
+struct RealtimeMetrics {
+    /// from the timestamp of the feed to the switch of the data using it
+    Histogram freshness;
+    Histogram apply;
+    Histogram rebuild;
+    std::atomic<uint64_t> nb_batches{0};
+    std::atomic<uint64_t> nb_messages{0};
+};
+
+/**
+ * Metrics of the requests, by api
+ *
+ * Each thread records in its own Recorder, they are merged only when
+ * the metrics are dumped.
+ */
+class Metrics {
+public:
+    class Recorder {
+        std::unique_ptr<ApiMetrics[]> apis;
+        ApiMetrics* get(pbnavitia::API api);
+        friend class Metrics;
+    public:
+        Recorder();
+        void record_request(pbnavitia::API api,
+                            const boost::posix_time::time_duration& duration,
+                            size_t request_size,
+                            size_t response_size,
+                            bool is_error);
+        void record_queue_wait(pbnavitia::API api, const boost::posix_time::time_duration& wait);
+    };
+
+    /// the recorder of a new thread, it lives as long as the Metrics
+    Recorder& new_recorder();
+
+    /// a line per api with the requests count, the percentiles, etc.
+    std::string dump() const;
+
+    RealtimeMetrics realtime;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<std::unique_ptr<Recorder>> recorders;
+};
+
+/**
+ * Answer the messages of the socket, never returns
+ *
+ * "memory" is answered with the memory report of the current data,
+ * "trace" with the spans of the traced requests as a chrome trace, any
+ * other message with Metrics::dump().
+ */
+void serve_metrics(zmq::context_t& context,
+                   const Metrics& metrics,
+                   const DataManager<type::Data>& data_manager,
+                   const std::string& socket_path);
+
+}} // namespace navitia::kraken
@@ -0,0 +1,181 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "queue_frontend.h"
+#include "utils/zmq.h"
+#include <cassert>
+#include <thread>
+
+namespace pt = boost::posix_time;
+
+namespace navitia { namespace kraken {
+
+// when max_queue is 0 the queue is only bounded by this capacity
+static const size_t default_queue_capacity = 64 * 1024;
+// tries before a worker sleeps on an empty queue
+static const int nb_spins = 100;
+
+bool RequestQueue::push(QueuedRequest&& request) {
+    if (! queue.try_push(std::move(request))) { return false; }
+    nb_queued.fetch_add(1, std::memory_order_relaxed);
+    // pairs with the fence of pop: either the worker sees the request, or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (nb_sleeping.load(std::memory_order_relaxed) > 0) {
+        std::lock_guard<std::mutex> lock(mutex);
+        not_empty.notify_one();
+    }
+    return true;
+}
+
+QueuedRequest RequestQueue::pop() {
+    QueuedRequest res;
+    for (int i = 0; i < nb_spins; ++i) {
+        if (queue.try_pop(res)) {
+            nb_queued.fetch_sub(1, std::memory_order_relaxed);
+            return res;
+        }
+        std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    nb_sleeping.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (! queue.try_pop(res)) {
+        not_empty.wait(lock);
+    }
+    nb_sleeping.fetch_sub(1, std::memory_order_relaxed);
+    nb_queued.fetch_sub(1, std::memory_order_relaxed);
+    return res;
+}
+
+QueueFrontend::Pool::Pool(WorkerClass c):
+    worker_class(std::move(c)),
+    queue(worker_class.max_queue ? worker_class.max_queue : default_queue_capacity) {}
+
+QueueFrontend::QueueFrontend(zmq::context_t& context, const std::vector<WorkerClass>& classes,
+                             bool with_batches, std::string replies_socket_path):
+    clients(context, ZMQ_ROUTER), replies(context, ZMQ_PULL), replies_path(std::move(replies_socket_path)),
+    last_report(pt::microsec_clock::universal_time()) {
+    for (const auto& worker_class: classes) {
+        pools.push_back(std::make_unique<Pool>(worker_class));
+    }
+    if (with_batches) {
+        batches = std::make_unique<zmq::socket_t>(context, ZMQ_PAIR);
+    }
+}
+
+void QueueFrontend::bind(const std::string& clients_socket_path) {
+    clients.bind(clients_socket_path.c_str());
+    replies.bind(replies_path.c_str());
+    if (batches) {
+        batches->bind(batches_socket_path().c_str());
+    }
+}
+
+size_t QueueFrontend::find_pool(pbnavitia::API api) const {
+    for (size_t i = 1; i < pools.size(); ++i) {
+        if (pools[i]->worker_class.apis.count(api)) { return i; }
+    }
+    return 0;
+}
+
+void QueueFrontend::handle_client() {
+    QueuedRequest request;
+    request.client = z_recv(clients);
+    {
+        std::string empty = z_recv(clients);
+        assert(empty.size() == 0);
+    }
+    clients.recv(&request.request);
+    if (has_more_frames(clients)) {
+        forward_batch(clients, batches.get(), request.client, std::move(request.request));
+        return;
+    }
+
+    request.api = peek_requested_api(request.request.data(), request.request.size());
+    request.received_at = pt::microsec_clock::universal_time();
+    auto& pool = *pools[find_pool(request.api)];
+    const auto& max_queue = pool.worker_class.max_queue;
+    // the request is kept by a failed push
+    if ((max_queue == 0 || pool.queue.size() < max_queue) && pool.queue.push(std::move(request))) {
+        return;
+    }
+    // admission control: better a fast error than a timeout
+    ++pool.nb_rejected;
+    const auto response = make_overloaded_response(pool.worker_class);
+    zmq::message_t reply(response.ByteSize());
+    response.SerializeToArray(reply.data(), reply.size());
+    z_send(clients, request.client, ZMQ_SNDMORE);
+    z_send(clients, "", ZMQ_SNDMORE);
+    clients.send(reply);
+}
+
+void QueueFrontend::handle_reply() {
+    const std::string client = z_recv(replies);
+    zmq::message_t reply;
+    replies.recv(&reply);
+    z_send(clients, client, ZMQ_SNDMORE);
+    z_send(clients, "", ZMQ_SNDMORE);
+    clients.send(reply);
+}
+
+void QueueFrontend::report() {
+    const auto now = pt::microsec_clock::universal_time();
+    if (now - last_report < pt::minutes(1)) { return; }
+    last_report = now;
+    for (auto& pool: pools) {
+        LOG4CPLUS_INFO(logger, "worker class " << pool->worker_class.name
+                       << ": queue depth " << pool->queue.size()
+                       << ", rejected requests " << pool->nb_rejected);
+        pool->nb_rejected = 0;
+    }
+}
+
+void QueueFrontend::run() {
+    std::vector<zmq::pollitem_t> items;
+    items.push_back({static_cast<void*>(clients), 0, ZMQ_POLLIN, 0});
+    items.push_back({static_cast<void*>(replies), 0, ZMQ_POLLIN, 0});
+    if (batches) {
+        items.push_back({static_cast<void*>(*batches), 0, ZMQ_POLLIN, 0});
+    }
+    while (true) {
+        zmq::poll(items.data(), int(items.size()), 1000);
+        if (items[1].revents & ZMQ_POLLIN) { handle_reply(); }
+        if (batches && (items[2].revents & ZMQ_POLLIN)) { forward_batch_reply(*batches, clients); }
+        if (items[0].revents & ZMQ_POLLIN) { handle_client(); }
+        report();
+    }
+}
+
+void send_reply(zmq::socket_t& replies, const std::string& client, zmq::message_t& reply) {
+    z_send(replies, client, ZMQ_SNDMORE);
+    replies.send(reply);
+}
+
+}} // namespace navitia::kraken
@@ -0,0 +1,127 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "kraken/mpmc_queue.h"
+#include "kraken/worker_classes.h"
+#include "type/request.pb.h"
+#include "utils/logger.h"
+#include <zmq.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace navitia { namespace kraken {
+
+struct QueuedRequest {
+    std::string client;
+    zmq::message_t request;
+    pbnavitia::API api = pbnavitia::UNKNOWN_API;
+    boost::posix_time::ptime received_at;
+};
+
+/**
+ * The requests of a worker class, waiting for a worker
+ *
+ * A worker spins a little on an empty queue before sleeping until the
+ * next push. The producer only takes the lock when a worker sleeps.
+ */
+class RequestQueue {
+    MpmcQueue<QueuedRequest> queue;
+    std::atomic<size_t> nb_queued{0};
+    std::atomic<int> nb_sleeping{0};
+    std::mutex mutex;
+    std::condition_variable not_empty;
+
+public:
+    explicit RequestQueue(size_t capacity): queue(capacity) {}
+
+    /// false if the queue is full
+    bool push(QueuedRequest&& request);
+    /// blocks until there is a request
+    QueuedRequest pop();
+    size_t size() const { return nb_queued.load(std::memory_order_relaxed); }
+};
+
+/**
+ * Front end handing the requests to the workers through lock-free queues
+ *
+ * An alternative to ClassLoadBalancer. A request is pushed in the queue
+ * of its worker class, where any idle worker pops it, and the workers
+ * push their replies on the replies socket. There is neither READY
+ * handshake nor bookkeeping of the idle workers, the thread only moves
+ * the frames of the clients, half of what ClassLoadBalancer does.
+ *
+ * The workers connect a PUSH socket to the replies socket and send the
+ * client and the reply with send_reply().
+ */
+class QueueFrontend {
+    struct Pool {
+        WorkerClass worker_class;
+        RequestQueue queue;
+        size_t nb_rejected = 0;
+        explicit Pool(WorkerClass c);
+    };
+
+    zmq::socket_t clients;
+    zmq::socket_t replies;
+    std::string replies_path;
+    std::vector<std::unique_ptr<Pool>> pools;
+    /// null when the batches are disabled
+    std::unique_ptr<zmq::socket_t> batches;
+    log4cplus::Logger logger = log4cplus::Logger::getInstance("queue_frontend");
+    boost::posix_time::ptime last_report;
+
+    size_t find_pool(pbnavitia::API api) const;
+    void handle_client();
+    void handle_reply();
+    void report();
+
+public:
+    QueueFrontend(zmq::context_t& context, const std::vector<WorkerClass>& classes,
+                  bool with_batches = false,
+                  std::string replies_socket_path = "inproc://replies");
+
+    void bind(const std::string& clients_socket_path);
+    const std::string& replies_socket_path() const { return replies_path; }
+    /// the queue of the i-th class given to the constructor
+    RequestQueue& queue(size_t i) { return pools.at(i)->queue; }
+    void run();
+};
+
+/// send the reply of a request popped from a RequestQueue
+void send_reply(zmq::socket_t& replies, const std::string& client, zmq::message_t& reply);
+
+}} // namespace navitia::kraken
@@ -0,0 +1,147 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "response_cache.h"
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace pt = boost::posix_time;
+
+namespace navitia { namespace kraken {
+
+ResponseCache::ResponseCache(std::map<pbnavitia::API, pt::time_duration> ttls,
+                             size_t max_size,
+                             int datetime_bucket):
+    ttls(std::move(ttls)), max_size(max_size), datetime_bucket(std::max(datetime_bucket, 1)) {}
+
+std::map<pbnavitia::API, pt::time_duration>
+ResponseCache::parse_ttls(const std::vector<std::string>& confs) {
+    std::map<pbnavitia::API, pt::time_duration> res;
+    for (const auto& conf: confs) {
+        std::vector<std::string> fields;
+        boost::split(fields, conf, boost::is_any_of(":"));
+        pbnavitia::API api;
+        if (fields.size() != 2 || ! pbnavitia::API_Parse(fields[0], &api)) {
+            throw std::invalid_argument("invalid cache ttl \"" + conf + "\", expected API:ttl_in_seconds");
+        }
+        try {
+            res[api] = pt::seconds(boost::lexical_cast<int>(fields[1]));
+        } catch (const boost::bad_lexical_cast&) {
+            throw std::invalid_argument("invalid cache ttl \"" + conf + "\", expected API:ttl_in_seconds");
+        }
+    }
+    return res;
+}
+
+boost::optional<ResponseCache::Key>
+ResponseCache::make_key(const pbnavitia::Request& request, size_t data_identifier) const {
+    if (! ttls.count(request.requested_api())) { return boost::none; }
+
+    // the request id is different for each call, and the current
+    // datetime is only significant at the precision of the bucket
+    pbnavitia::Request copy(request);
+    copy.clear_request_id();
+    copy.clear__current_datetime();
+    const auto bucket = request._current_datetime() / datetime_bucket;
+    return Key{std::to_string(data_identifier) + ':' + std::to_string(bucket) + ':' + copy.SerializeAsString(),
+               data_identifier,
+               request.requested_api()};
+}
+
+bool ResponseCache::check_data(size_t key_data_identifier) {
+    if (key_data_identifier < data_identifier) { return false; }
+    if (key_data_identifier > data_identifier) {
+        // the data has been swapped, every response is outdated
+        lru.clear();
+        entries.clear();
+        current_size = 0;
+        data_identifier = key_data_identifier;
+    }
+    return true;
+}
+
+void ResponseCache::erase(Lru::iterator it) {
+    current_size -= it->key.size() + it->response.size();
+    entries.erase(it->key);
+    lru.erase(it);
+}
+
+boost::optional<std::string> ResponseCache::get(const Key& key, const pt::ptime& now) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (check_data(key.data_identifier)) {
+        const auto search = entries.find(key.key);
+        if (search != entries.end()) {
+            if (search->second->expiration > now) {
+                ++hits;
+                lru.splice(lru.begin(), lru, search->second);
+                return search->second->response;
+            }
+            erase(search->second);
+        }
+    }
+    ++misses;
+    return boost::none;
+}
+
+void ResponseCache::put(const Key& key, std::string response, const pt::ptime& now) {
+    const size_t entry_size = key.key.size() + response.size();
+    if (entry_size > max_size) { return; }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (! check_data(key.data_identifier)) { return; }
+    const auto search = entries.find(key.key);
+    if (search != entries.end()) { erase(search->second); }
+    while (current_size + entry_size > max_size && ! lru.empty()) {
+        erase(std::prev(lru.end()));
+    }
+    lru.push_front(Entry{key.key, std::move(response), now + ttls.at(key.api)});
+    entries[key.key] = lru.begin();
+    current_size += entry_size;
+}
+
+size_t ResponseCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return current_size;
+}
+
+size_t ResponseCache::nb_hits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return hits;
+}
+
+size_t ResponseCache::nb_misses() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return misses;
+}
+
+}} // namespace navitia::kraken
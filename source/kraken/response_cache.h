@@ -0,0 +1,105 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/request.pb.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/optional.hpp>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace navitia { namespace kraken {
+
+/**
+ * Cache of the serialized responses, shared by the workers
+ *
+ * Only the apis with a ttl are cached. A response is keyed by the request
+ * (without its id), the data it has been computed on and the bucket of
+ * its current datetime. When a newer data is seen, the whole cache is
+ * dropped. The least recently used responses are evicted to stay under
+ * max_size bytes.
+ */
+class ResponseCache {
+public:
+    struct Key {
+        std::string key;
+        size_t data_identifier;
+        pbnavitia::API api;
+    };
+
+    ResponseCache(std::map<pbnavitia::API, boost::posix_time::time_duration> ttls,
+                  size_t max_size,
+                  int datetime_bucket);
+
+    /// parse the ttls of the configuration, as API:ttl_in_seconds
+    static std::map<pbnavitia::API, boost::posix_time::time_duration>
+    parse_ttls(const std::vector<std::string>& confs);
+
+    /// the key of the request, none if its api is not cached
+    boost::optional<Key> make_key(const pbnavitia::Request& request, size_t data_identifier) const;
+
+    boost::optional<std::string> get(const Key& key, const boost::posix_time::ptime& now);
+    void put(const Key& key, std::string response, const boost::posix_time::ptime& now);
+
+    size_t size() const;
+    size_t nb_hits() const;
+    size_t nb_misses() const;
+
+private:
+    struct Entry {
+        std::string key;
+        std::string response;
+        boost::posix_time::ptime expiration;
+    };
+    typedef std::list<Entry> Lru;
+
+    const std::map<pbnavitia::API, boost::posix_time::time_duration> ttls;
+    const size_t max_size;
+    const int datetime_bucket;
+
+    mutable std::mutex mutex;
+    Lru lru; // most recently used first
+    std::unordered_map<std::string, Lru::iterator> entries;
+    size_t current_size = 0;
+    size_t data_identifier = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+
+    /// false if the key is from an older data, the whole cache is dropped if newer
+    bool check_data(size_t key_data_identifier);
+    void erase(Lru::iterator it);
+};
+
+}} // namespace navitia::kraken
@@ -0,0 +1,86 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "rt_batch.h"
+#include "type/datetime.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <unordered_map>
+
+namespace navitia {
+
+RtBatch parse_rt_batch(const std::vector<std::string>& bodies, size_t nb_threads) {
+    RtBatch batch;
+    batch.messages.resize(bodies.size());
+    std::vector<char> is_valid(bodies.size(), false);
+    std::atomic<size_t> next(0);
+    auto parse = [&]() {
+        for (size_t i = next++; i < bodies.size(); i = next++) {
+            is_valid[i] = batch.messages[i].ParseFromString(bodies[i]);
+        }
+    };
+    nb_threads = std::min(nb_threads, bodies.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < nb_threads; ++i) {
+        threads.emplace_back(parse);
+    }
+    parse();
+    for (auto& thread: threads) { thread.join(); }
+
+    // id -> position in updates of its last occurrence
+    std::unordered_map<std::string, size_t> last_update;
+    for (size_t i = 0; i < batch.messages.size(); ++i) {
+        if (! is_valid[i]) {
+            ++batch.nb_invalid;
+            continue;
+        }
+        const auto& message = batch.messages[i];
+        const auto timestamp = navitia::from_posix_timestamp(message.header().timestamp());
+        for (const auto& entity: message.entity()) {
+            ++batch.nb_entities;
+            const auto it = last_update.find(entity.id());
+            if (it != last_update.end()) {
+                batch.updates[it->second].entity = nullptr;
+                ++batch.nb_coalesced;
+                it->second = batch.updates.size();
+            } else {
+                last_update.emplace(entity.id(), batch.updates.size());
+            }
+            batch.updates.push_back({&entity, timestamp});
+        }
+    }
+    batch.updates.erase(std::remove_if(batch.updates.begin(), batch.updates.end(),
+                                       [](const RtEntityUpdate& u) { return u.entity == nullptr; }),
+                        batch.updates.end());
+    return batch;
+}
+
+}
@@ -0,0 +1,72 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/gtfs-realtime.pb.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <string>
+#include <vector>
+
+namespace navitia {
+
+/// an entity to apply, with the timestamp of its feed
+struct RtEntityUpdate {
+    const transit_realtime::FeedEntity* entity;
+    boost::posix_time::ptime timestamp;
+};
+
+/**
+ * The realtime messages of a batch, ready to be applied
+ *
+ * When several entities of the batch have the same id (a trip updated
+ * several times by kirin, a disruption updated then deleted by chaos...)
+ * only the last one is kept, as each one replaces the previous state.
+ * The updates are in the order of the last occurrence of their id.
+ */
+struct RtBatch {
+    /// the parsed messages, owning the entities of updates
+    std::vector<transit_realtime::FeedMessage> messages;
+    std::vector<RtEntityUpdate> updates;
+    size_t nb_invalid = 0;
+    size_t nb_entities = 0;
+    size_t nb_coalesced = 0;
+
+    RtBatch() = default;
+    RtBatch(RtBatch&&) = default;
+    RtBatch& operator=(RtBatch&&) = default;
+    RtBatch(const RtBatch&) = delete;
+    RtBatch& operator=(const RtBatch&) = delete;
+};
+
+/// parse the messages on nb_threads threads, and coalesce their entities
+RtBatch parse_rt_batch(const std::vector<std::string>& bodies, size_t nb_threads);
+
+}
@@ -0,0 +1,82 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "rt_scheduler.h"
+#include <algorithm>
+
+namespace pt = boost::posix_time;
+
+namespace navitia { namespace kraken {
+
+// weight of the last batch in the moving averages
+static const double smoothing = 0.3;
+
+RtScheduler::RtScheduler(const pt::time_duration& target_latency, size_t max_batch_size):
+    target_us(target_latency.total_microseconds()), max_batch_size(std::max<size_t>(1, max_batch_size)) {}
+
+double RtScheduler::available_us() const {
+    return std::max(0., target_us - rebuild_us);
+}
+
+size_t RtScheduler::batch_size() const {
+    // when the rebuild alone is longer than the target, the batches are as
+    // big as possible to keep up with the flow
+    if (available_us() == 0) { return max_batch_size; }
+    const double nb = available_us() / 2 / std::max(1., message_us);
+    return std::max<size_t>(1, std::min<double>(nb, max_batch_size));
+}
+
+pt::time_duration RtScheduler::collect_window() const {
+    if (available_us() == 0) { return pt::time_duration(pt::pos_infin); }
+    return pt::microseconds(int64_t(available_us() / 2));
+}
+
+pt::time_duration RtScheduler::idle_sleep(const pt::time_duration& max_sleep) const {
+    // a message coming during the sleep waits as if it was collected
+    return std::min<pt::time_duration>(max_sleep, pt::microseconds(int64_t(available_us() / 2)));
+}
+
+void RtScheduler::record_batch(size_t nb_messages,
+                               const pt::time_duration& apply_duration,
+                               const pt::time_duration& rebuild_duration) {
+    if (nb_messages == 0) { return; }
+    const double rebuild = rebuild_duration.total_microseconds();
+    const double message = double(apply_duration.total_microseconds()) / nb_messages;
+    if (! has_history) {
+        rebuild_us = rebuild;
+        message_us = message;
+        has_history = true;
+        return;
+    }
+    rebuild_us += smoothing * (rebuild - rebuild_us);
+    message_us += smoothing * (message - message_us);
+}
+
+}} // namespace navitia::kraken
@@ -0,0 +1,82 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace navitia { namespace kraken {
+
+/**
+ * Pace of the realtime ingestion, for a target latency
+ *
+ * A message is visible once its batch is applied and raptor rebuilt.
+ * The rebuild cost is paid once per batch: the bigger the batch, the
+ * better it is amortized, but the longer its first messages wait. What
+ * is left of the target once the rebuild is paid is split between the
+ * collection of the batch and the application of its messages. The
+ * costs are the moving averages of the last batches.
+ */
+class RtScheduler {
+public:
+    RtScheduler(const boost::posix_time::time_duration& target_latency, size_t max_batch_size);
+
+    /// the maximum number of messages of the next batch
+    size_t batch_size() const;
+    /**
+     * how long the next batch can be collected after its first message
+     *
+     * Infinite when the rebuild alone exceeds the target: the batch then
+     * takes what is waiting, up to batch_size().
+     */
+    boost::posix_time::time_duration collect_window() const;
+    /// how long to sleep when the queues are empty, at most max_sleep
+    boost::posix_time::time_duration idle_sleep(const boost::posix_time::time_duration& max_sleep) const;
+
+    void record_batch(size_t nb_messages,
+                      const boost::posix_time::time_duration& apply_duration,
+                      const boost::posix_time::time_duration& rebuild_duration);
+
+    double rebuild_cost_us() const { return rebuild_us; }
+    double message_cost_us() const { return message_us; }
+
+private:
+    double target_us;
+    size_t max_batch_size;
+    // nothing is known before the first batch, a rebuild is assumed to be costly
+    double rebuild_us = 1000000;
+    double message_us = 1000;
+    bool has_history = false;
+
+    /// the part of the target left once the rebuild is paid
+    double available_us() const;
+};
+
+}} // namespace navitia::kraken
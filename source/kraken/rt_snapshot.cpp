@@ -0,0 +1,217 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "rt_snapshot.h"
+#include "type/datetime.h"
+#include "type/chaos.pb.h"
+#include "utils/exception.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <boost/algorithm/string/join.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace gpio = google::protobuf::io;
+namespace pt = boost::posix_time;
+
+namespace navitia {
+
+// once expired, an entity has no effect on the data anymore
+static pt::ptime expiry(const transit_realtime::FeedEntity& entity) {
+    if (entity.HasExtension(chaos::disruption)) {
+        const auto& disruption = entity.GetExtension(chaos::disruption);
+        if (disruption.publication_period().has_end()) {
+            return navitia::from_posix_timestamp(disruption.publication_period().end());
+        }
+        pt::ptime last_end(pt::neg_infin);
+        for (const auto& impact: disruption.impacts()) {
+            for (const auto& period: impact.application_periods()) {
+                if (! period.has_end()) { return pt::pos_infin; }
+                last_end = std::max(last_end, navitia::from_posix_timestamp(period.end()));
+            }
+        }
+        return last_end.is_neg_infinity() ? pt::ptime(pt::pos_infin) : last_end;
+    }
+    if (entity.has_trip_update() && entity.trip_update().trip().has_start_date()) {
+        try {
+            // the start date is local and a trip can run past midnight
+            const auto start_date = boost::gregorian::from_undelimited_string(
+                entity.trip_update().trip().start_date());
+            return pt::ptime(start_date + boost::gregorian::days(2));
+        } catch (const std::exception&) {}
+    }
+    return pt::pos_infin;
+}
+
+void RtSnapshot::add(const RtBatch& batch) {
+    for (const auto& update: batch.updates) {
+        if (update.entity->is_deleted()) {
+            records.erase(update.entity->id());
+            continue;
+        }
+        transit_realtime::FeedMessage message;
+        message.mutable_header()->set_gtfs_realtime_version("1.0");
+        message.mutable_header()->set_timestamp(navitia::to_posix_timestamp(update.timestamp));
+        *message.add_entity() = *update.entity;
+        auto& record = records[update.entity->id()];
+        record.sequence = next_sequence++;
+        record.expiry = expiry(*update.entity);
+        message.SerializeToString(&record.message);
+    }
+}
+
+size_t RtSnapshot::prune(const pt::ptime& now) {
+    size_t nb_pruned = 0;
+    for (auto it = records.begin(); it != records.end();) {
+        if (it->second.expiry < now) {
+            it = records.erase(it);
+            ++nb_pruned;
+        } else {
+            ++it;
+        }
+    }
+    return nb_pruned;
+}
+
+void RtSnapshot::clear() {
+    records.clear();
+    snapshot_topics.clear();
+}
+
+std::vector<std::string> RtSnapshot::messages() const {
+    std::vector<const Record*> ordered;
+    ordered.reserve(records.size());
+    for (const auto& id_record: records) { ordered.push_back(&id_record.second); }
+    std::sort(ordered.begin(), ordered.end(),
+              [](const Record* a, const Record* b) { return a->sequence < b->sequence; });
+    std::vector<std::string> res;
+    res.reserve(ordered.size());
+    for (const auto* record: ordered) { res.push_back(record->message); }
+    return res;
+}
+
+void RtSnapshot::save(const std::string& path, const std::vector<std::string>& topics) const {
+    const std::string tmp_path = path + ".tmp";
+    const int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw navitia::exception("impossible to write the realtime snapshot " + tmp_path);
+    }
+    bool written;
+    {
+        gpio::FileOutputStream raw_output(fd);
+        {
+            gpio::CodedOutputStream output(&raw_output);
+            const std::string joined_topics = boost::algorithm::join(topics, ",");
+            output.WriteVarint32(uint32_t(joined_topics.size()));
+            output.WriteString(joined_topics);
+            for (const auto& message: messages()) {
+                output.WriteVarint32(uint32_t(message.size()));
+                output.WriteString(message);
+            }
+            written = ! output.HadError();
+        }
+        // the data must be on disk before the rename makes it the snapshot
+        written = raw_output.Flush() && written && ::fsync(fd) == 0;
+    }
+    if (::close(fd) != 0 || ! written) {
+        std::remove(tmp_path.c_str());
+        throw navitia::exception("impossible to write the realtime snapshot " + tmp_path);
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        throw navitia::exception("impossible to rename the realtime snapshot to " + path);
+    }
+    // and the rename too
+    const auto slash = path.rfind('/');
+    const std::string dir = slash == std::string::npos ? "." : path.substr(0, std::max<size_t>(slash, 1));
+    const int dir_fd = ::open(dir.c_str(), O_RDONLY);
+    if (dir_fd >= 0) {
+        ::fsync(dir_fd);
+        ::close(dir_fd);
+    }
+}
+
+void RtSnapshot::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (! file) {
+        throw navitia::exception("impossible to open the realtime snapshot " + path);
+    }
+    clear();
+    gpio::IstreamInputStream raw_input(&file);
+    bool has_topics = false;
+    while (true) {
+        // a CodedInputStream per message, they have a limit on the total size read
+        gpio::CodedInputStream input(&raw_input);
+        uint32_t size;
+        if (! input.ReadVarint32(&size)) { break; }
+        std::string bytes;
+        if (! input.ReadString(&bytes, int(size))) {
+            clear();
+            throw navitia::exception("truncated realtime snapshot " + path);
+        }
+        if (! has_topics) {
+            if (! bytes.empty()) {
+                boost::algorithm::split(snapshot_topics, bytes, boost::algorithm::is_any_of(","));
+            }
+            has_topics = true;
+            continue;
+        }
+        transit_realtime::FeedMessage message;
+        if (! message.ParseFromString(bytes) || message.entity_size() != 1) {
+            clear();
+            throw navitia::exception("invalid message in the realtime snapshot " + path);
+        }
+        const auto& entity = message.entity(0);
+        if (entity.is_deleted()) { continue; }
+        auto& record = records[entity.id()];
+        record.sequence = next_sequence++;
+        record.expiry = expiry(entity);
+        record.message = std::move(bytes);
+    }
+    if (! has_topics) {
+        throw navitia::exception("empty realtime snapshot " + path);
+    }
+}
+
+boost::posix_time::ptime rt_snapshot_time(const std::string& path) {
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) {
+        return boost::posix_time::not_a_date_time;
+    }
+    return boost::posix_time::from_time_t(st.st_mtime);
+}
+
+}
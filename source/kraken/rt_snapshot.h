@@ -0,0 +1,87 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "kraken/rt_batch.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace navitia {
+
+/**
+ * The realtime state applied on the data, persisted to restart without
+ * waiting for a full reload from kirin
+ *
+ * The last applied entity of each id is kept as a FeedMessage with only
+ * this entity and the timestamp of its feed, thus replaying the messages
+ * in their order gives back the state. The deleted entities are dropped,
+ * and the outdated ones are pruned.
+ *
+ * The file is the topics of the snapshot, joined by ',', then the
+ * messages, each one being its size as a varint followed by its bytes.
+ */
+class RtSnapshot {
+    struct Record {
+        uint64_t sequence;
+        // pos_infin if it never expires
+        boost::posix_time::ptime expiry;
+        std::string message;
+    };
+    std::unordered_map<std::string, Record> records;
+    uint64_t next_sequence = 0;
+    std::vector<std::string> snapshot_topics;
+
+public:
+    /// keep the updates of an applied batch, replacing or deleting the previous entities of same id
+    void add(const RtBatch& batch);
+    /// remove the entities expired at now, returns their number
+    size_t prune(const boost::posix_time::ptime& now);
+    void clear();
+    size_t size() const { return records.size(); }
+
+    /// the messages to replay, in the order they were applied
+    std::vector<std::string> messages() const;
+    /// the realtime topics the snapshot was built with
+    const std::vector<std::string>& topics() const { return snapshot_topics; }
+
+    /// written and synced in a temporary file renamed over path, a crash never leaves a truncated snapshot
+    void save(const std::string& path, const std::vector<std::string>& topics) const;
+    /// throws navitia::exception if the file can't be read
+    void load(const std::string& path);
+};
+
+/// time of the last write of the snapshot, not_a_date_time if there is none
+boost::posix_time::ptime rt_snapshot_time(const std::string& path);
+
+}
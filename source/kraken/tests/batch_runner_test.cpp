@@ -0,0 +1,86 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_batch_runner
+#include <boost/test/unit_test.hpp>
+#include "kraken/batch_runner.h"
+#include "kraken/data_manager.h"
+#include "kraken/configuration.h"
+#include "kraken/tests/journey_test_data.h"
+
+using namespace navitia::kraken;
+
+struct logger_initialized {
+    logger_initialized()   { init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE( logger_initialized )
+
+struct fixture: journey_data {
+    DataManager<navitia::type::Data> data_manager;
+
+    fixture() { data_manager.set_data(b.data.release()); }
+};
+
+/*
+ * the responses are in the order of the requests, whatever the thread
+ * that processed them, and an invalid request doesn't fail the batch
+ */
+BOOST_FIXTURE_TEST_CASE(batch_responses_in_order, fixture) {
+    BatchRunner runner(data_manager, Configuration(), 3);
+
+    std::vector<std::string> requests;
+    for (size_t i = 0; i < 10; ++i) {
+        if (i % 3 == 2) {
+            requests.push_back("this is not a protobuf");
+        } else {
+            requests.push_back(journey_request(i % 2 ? "C" : "B"));
+        }
+    }
+    const auto responses = runner.run(requests);
+
+    BOOST_REQUIRE_EQUAL(responses.size(), requests.size());
+    for (size_t i = 0; i < responses.size(); ++i) {
+        if (i % 3 == 2) {
+            BOOST_REQUIRE(responses[i].has_error());
+            BOOST_CHECK_EQUAL(responses[i].error().id(), pbnavitia::Error::invalid_protobuf_request);
+            continue;
+        }
+        BOOST_CHECK(! responses[i].has_error());
+        BOOST_REQUIRE_GE(responses[i].journeys_size(), 1);
+        BOOST_CHECK_EQUAL(responses[i].journeys(0).arrival_date_time(),
+                          navitia::test::to_posix_timestamp(i % 2 ? "20150314T100000" : "20150314T090000"));
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(empty_batch, fixture) {
+    BatchRunner runner(data_manager, Configuration(), 2);
+    BOOST_CHECK(runner.run({}).empty());
+}
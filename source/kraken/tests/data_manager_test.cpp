@@ -41,7 +41,10 @@ class Data{
     public:
         bool load(const std::string&,
                   const boost::optional<std::string>&,
-                  const std::vector<std::string>&) {
+                  const std::vector<std::string>&,
+                  const Data*,
+                  const navitia::time_duration&,
+                  size_t) {
             return load_status;
         }
         mutable std::atomic<bool> is_connected_to_rabbitmq;
@@ -599,3 +599,33 @@ BOOST_AUTO_TEST_CASE(two_ptobjects) {
     ptobject = impact.informed_entities(1);
     BOOST_CHECK_EQUAL(ptobject.uri(), "uri2");
 }
+
+BOOST_AUTO_TEST_CASE(disruptions_given_to_the_sink) {
+    std::vector<std::unique_ptr<chaos::Disruption>> disruptions;
+    navitia::DisruptionDatabaseReader reader([&](std::unique_ptr<chaos::Disruption> d) {
+        disruptions.push_back(std::move(d));
+    });
+
+    Const_it const_it;
+    const_it.set_cause("1", "wording", "11", "22");
+    const_it.set_impact("1", "11", "22");
+    const_it.set_severity("2", "wording", "22", "33",
+            "blocking", "color", "2");
+    const_it.set_application_period("0", "1", "2");
+    const_it.set_ptobject("id", "uri", "line", "1", "2");
+    const_it.set_disruption("1", "22");
+    reader(const_it);
+    reader(const_it);
+    // a disruption is complete when the rows of the next one begin
+    BOOST_CHECK(disruptions.empty());
+    const_it.set_disruption("2", "22");
+    const_it.set_impact("2", "11", "22");
+    reader(const_it);
+    BOOST_REQUIRE_EQUAL(disruptions.size(), 1);
+    reader.finalize();
+    BOOST_REQUIRE_EQUAL(disruptions.size(), 2);
+    BOOST_CHECK_EQUAL(disruptions[0]->id(), "1");
+    BOOST_CHECK_EQUAL(disruptions[0]->impacts_size(), 1);
+    BOOST_CHECK_EQUAL(disruptions[1]->id(), "2");
+    BOOST_CHECK_EQUAL(disruptions[1]->impacts(0).id(), "2");
+}
@@ -0,0 +1,87 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "ed/build_helper.h"
+#include "tests/utils_test.h"
+#include "type/pt_data.h"
+#include "type/request.pb.h"
+#include <limits>
+
+/**
+ * data set of the kraken tests replaying requests
+ *
+ * l1: A 8:00 > B 9:00
+ * l2: A 9:00 > C 10:00
+ */
+struct journey_data {
+    ed::builder b;
+
+    journey_data(): b("20150314") {
+        b.sa("A", 0, 0);
+        b.sa("B", 0, 0);
+        b.sa("C", 0, 0);
+        b.vj("l1")("stop_point:A", "8:00"_t)("stop_point:B", "9:00"_t);
+        b.vj("l2")("stop_point:A", "9:00"_t)("stop_point:C", "10:00"_t);
+        b.finish();
+        b.generate_dummy_basis();
+        b.data->pt_data->index();
+        b.data->build_raptor();
+        b.data->build_uri();
+    }
+};
+
+/// a serialized journey request from A at 8:00
+inline std::string journey_request(const std::string& destination) {
+    pbnavitia::Request req;
+    req.set_requested_api(pbnavitia::PLANNER);
+    pbnavitia::JourneysRequest* j = req.mutable_journeys();
+    j->set_clockwise(true);
+    j->set_wheelchair(false);
+    j->set_realtime_level(pbnavitia::ADAPTED_SCHEDULE);
+    j->set_max_duration(std::numeric_limits<int32_t>::max());
+    j->set_max_transfers(42);
+    j->add_datetimes(navitia::test::to_posix_timestamp("20150314T080000"));
+    auto sn_params = j->mutable_streetnetwork_params();
+    sn_params->set_origin_mode("walking");
+    sn_params->set_destination_mode("walking");
+    sn_params->set_walking_speed(1);
+    sn_params->set_bike_speed(1);
+    sn_params->set_car_speed(1);
+    sn_params->set_bss_speed(1);
+    pbnavitia::LocationContext* from = j->add_origin();
+    from->set_place("A");
+    from->set_access_duration(0);
+    pbnavitia::LocationContext* to = j->add_destination();
+    to->set_place(destination);
+    to->set_access_duration(0);
+    return req.SerializeAsString();
+}
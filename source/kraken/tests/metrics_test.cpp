@@ -0,0 +1,94 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_metrics
+#include <boost/test/unit_test.hpp>
+#include "kraken/metrics.h"
+#include "utils/logger.h"
+#include <thread>
+
+using namespace navitia::kraken;
+namespace pt = boost::posix_time;
+
+struct logger_initialized {
+    logger_initialized()   { init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE( logger_initialized )
+
+BOOST_AUTO_TEST_CASE(histogram_buckets) {
+    for (uint64_t value: {0, 1, 15, 16, 17, 31, 32, 33, 100, 1000, 123456, 4000000000}) {
+        const auto bucket = Histogram::bucket(value);
+        BOOST_REQUIRE_LT(bucket, Histogram::nb_buckets);
+        const auto lowest = Histogram::bucket_value(bucket);
+        BOOST_CHECK_LE(lowest, value);
+        // at most 1/16th of error
+        BOOST_CHECK_LE(value - lowest, value / 16);
+        BOOST_CHECK_EQUAL(Histogram::bucket(lowest), bucket);
+    }
+    // too big values are in the last bucket
+    BOOST_CHECK_EQUAL(Histogram::bucket(uint64_t(1) << 40), Histogram::nb_buckets - 1);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_percentiles) {
+    Histogram histogram;
+    std::vector<uint64_t> counts;
+    histogram.merge_into(counts);
+    BOOST_CHECK_EQUAL(percentile(counts, 0.99), 0);
+
+    for (uint64_t i = 1; i <= 100; ++i) { histogram.add(i * 10); }
+    counts.clear();
+    histogram.merge_into(counts);
+    BOOST_CHECK_CLOSE(double(percentile(counts, 0.5)), 500., 100. / 16);
+    BOOST_CHECK_CLOSE(double(percentile(counts, 0.99)), 990., 100. / 16);
+    BOOST_CHECK_CLOSE(double(percentile(counts, 1)), 1000., 100. / 16);
+    BOOST_CHECK_EQUAL(percentile(counts, 0), 10);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_merged_by_api) {
+    Metrics metrics;
+    auto& recorder1 = metrics.new_recorder();
+    auto& recorder2 = metrics.new_recorder();
+    std::thread thread([&]() {
+        for (int i = 0; i < 1000; ++i) {
+            recorder1.record_request(pbnavitia::PLANNER, pt::milliseconds(10), 100, 1000, i % 100 == 0);
+        }
+    });
+    recorder2.record_request(pbnavitia::PLANNER, pt::milliseconds(10), 100, 1000, false);
+    recorder2.record_request(pbnavitia::places, pt::milliseconds(1), 10, 20, false);
+    recorder2.record_queue_wait(pbnavitia::places, pt::milliseconds(2));
+    thread.join();
+
+    const auto dump = metrics.dump();
+    BOOST_CHECK_NE(dump.find("\nPLANNER 1001 10 100100 1001000 "), std::string::npos);
+    BOOST_CHECK_NE(dump.find("\nplaces 1 0 10 20 "), std::string::npos);
+    // no line for the apis without request
+    BOOST_CHECK_EQUAL(dump.find("ISOCHRONE"), std::string::npos);
+}
@@ -0,0 +1,138 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_queue_frontend
+#include <boost/test/unit_test.hpp>
+#include "kraken/mpmc_queue.h"
+#include "kraken/queue_frontend.h"
+#include "utils/zmq.h"
+#include "tests/utils_test.h"
+#include <atomic>
+#include <thread>
+
+namespace nk = navitia::kraken;
+
+struct logger_initialized {
+    logger_initialized()   { init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE( logger_initialized )
+
+BOOST_AUTO_TEST_CASE(mpmc_queue_test) {
+    nk::MpmcQueue<int> queue(3);
+    BOOST_CHECK_EQUAL(queue.capacity(), 4);
+    for (int i = 0; i < 4; ++i) {
+        BOOST_CHECK(queue.try_push(std::move(i)));
+    }
+    BOOST_CHECK(! queue.try_push(42));
+    int value = -1;
+    for (int i = 0; i < 4; ++i) {
+        BOOST_REQUIRE(queue.try_pop(value));
+        BOOST_CHECK_EQUAL(value, i);
+    }
+    BOOST_CHECK(! queue.try_pop(value));
+    // the cells are reused on the next lap
+    BOOST_CHECK(queue.try_push(42));
+    BOOST_REQUIRE(queue.try_pop(value));
+    BOOST_CHECK_EQUAL(value, 42);
+}
+
+BOOST_AUTO_TEST_CASE(mpmc_queue_threads_test) {
+    nk::MpmcQueue<uint64_t> queue(64);
+    const uint64_t nb_by_producer = 100000;
+    const int nb_producers = 4, nb_consumers = 4;
+    std::atomic<uint64_t> sum(0), nb_popped(0);
+    std::vector<std::thread> threads;
+    for (int p = 0; p < nb_producers; ++p) {
+        threads.emplace_back([&]() {
+            for (uint64_t i = 1; i <= nb_by_producer; ++i) {
+                uint64_t value = i;
+                while (! queue.try_push(std::move(value))) { std::this_thread::yield(); }
+            }
+        });
+    }
+    for (int c = 0; c < nb_consumers; ++c) {
+        threads.emplace_back([&]() {
+            uint64_t value;
+            while (nb_popped < nb_producers * nb_by_producer) {
+                if (queue.try_pop(value)) {
+                    sum += value;
+                    ++nb_popped;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) { thread.join(); }
+    BOOST_CHECK_EQUAL(nb_popped, nb_producers * nb_by_producer);
+    BOOST_CHECK_EQUAL(sum, nb_producers * nb_by_producer * (nb_by_producer + 1) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(request_queue_wakes_up_test) {
+    nk::RequestQueue queue(16);
+    std::string popped;
+    std::thread worker([&]() { popped = queue.pop().client; });
+    // the worker is likely sleeping by now
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    nk::QueuedRequest request;
+    request.client = "client";
+    BOOST_CHECK(queue.push(std::move(request)));
+    worker.join();
+    BOOST_CHECK_EQUAL(popped, "client");
+    BOOST_CHECK_EQUAL(queue.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(frontend_round_trip_test) {
+    // the frontend never returns: its thread is detached and the context leaked
+    auto* context = new zmq::context_t(1);
+    auto classes = nk::parse_worker_classes({"light:1:1:places"}, 1, 0);
+    auto* frontend = new nk::QueueFrontend(*context, classes, false, "inproc://test_replies");
+    frontend->bind("inproc://test_clients");
+    std::thread([frontend]() { frontend->run(); }).detach();
+    // an echo worker for the light class only
+    std::thread([context, frontend]() {
+        zmq::socket_t replies(*context, ZMQ_PUSH);
+        replies.connect(frontend->replies_socket_path().c_str());
+        while (true) {
+            auto request = frontend->queue(1).pop();
+            nk::send_reply(replies, request.client, request.request);
+        }
+    }).detach();
+
+    zmq::socket_t client(*context, ZMQ_REQ);
+    client.connect("inproc://test_clients");
+    pbnavitia::Request request;
+    request.set_requested_api(pbnavitia::places);
+    for (int i = 0; i < 10; ++i) {
+        z_send(client, request.SerializeAsString());
+        BOOST_CHECK_EQUAL(z_recv(client), request.SerializeAsString());
+    }
+}
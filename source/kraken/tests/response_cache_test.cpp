@@ -0,0 +1,112 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE response_cache_test
+#include <boost/test/unit_test.hpp>
+#include "kraken/response_cache.h"
+#include "tests/utils_test.h"
+
+using namespace navitia::kraken;
+namespace pt = boost::posix_time;
+
+static pbnavitia::Request make_request(pbnavitia::API api, const std::string& id, uint64_t datetime) {
+    pbnavitia::Request request;
+    request.set_requested_api(api);
+    request.set_request_id(id);
+    request.set__current_datetime(datetime);
+    return request;
+}
+
+BOOST_AUTO_TEST_CASE(parse_ttls_test) {
+    const auto ttls = ResponseCache::parse_ttls({"places:60", "PTREFERENTIAL:600"});
+    BOOST_REQUIRE_EQUAL(ttls.size(), 2);
+    BOOST_CHECK_EQUAL(ttls.at(pbnavitia::places), pt::seconds(60));
+    BOOST_CHECK_EQUAL(ttls.at(pbnavitia::PTREFERENTIAL), pt::seconds(600));
+    BOOST_CHECK_THROW(ResponseCache::parse_ttls({"places"}), std::invalid_argument);
+    BOOST_CHECK_THROW(ResponseCache::parse_ttls({"NOT_AN_API:60"}), std::invalid_argument);
+    BOOST_CHECK_THROW(ResponseCache::parse_ttls({"places:a"}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_test) {
+    ResponseCache cache({{pbnavitia::places, pt::seconds(60)}}, 1024 * 1024, 60);
+    const pt::ptime now(boost::gregorian::date(2016, 1, 1));
+
+    // only the apis with a ttl are cached
+    BOOST_CHECK(! cache.make_key(make_request(pbnavitia::PLANNER, "1", 120), 1));
+
+    const auto key = cache.make_key(make_request(pbnavitia::places, "1", 120), 1);
+    BOOST_REQUIRE(key);
+    BOOST_CHECK(! cache.get(*key, now));
+    cache.put(*key, "response", now);
+
+    // same request with another id, in the same datetime bucket
+    const auto same_key = cache.make_key(make_request(pbnavitia::places, "2", 150), 1);
+    BOOST_REQUIRE(same_key);
+    BOOST_CHECK_EQUAL(*cache.get(*same_key, now), "response");
+    BOOST_CHECK_EQUAL(cache.nb_hits(), 1);
+
+    // another datetime bucket
+    const auto other_bucket = cache.make_key(make_request(pbnavitia::places, "3", 180), 1);
+    BOOST_CHECK(! cache.get(*other_bucket, now));
+
+    // expired
+    BOOST_CHECK(! cache.get(*key, now + pt::seconds(61)));
+
+    // a new data drops the cache, the late responses of the old data are ignored
+    cache.put(*key, "response", now);
+    const auto new_data_key = cache.make_key(make_request(pbnavitia::places, "1", 120), 2);
+    BOOST_CHECK(! cache.get(*new_data_key, now));
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    cache.put(*key, "response", now);
+    BOOST_CHECK_EQUAL(cache.size(), 0);
+    BOOST_CHECK(! cache.get(*key, now));
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_budget_test) {
+    const auto first = make_request(pbnavitia::places, "1", 0);
+    const auto key_size = ResponseCache({{pbnavitia::places, pt::seconds(60)}}, 0, 60)
+            .make_key(first, 1)->key.size();
+    // room for 2 responses of 10 bytes
+    ResponseCache cache({{pbnavitia::places, pt::seconds(60)}}, 2 * (key_size + 10), 60);
+    const pt::ptime now(boost::gregorian::date(2016, 1, 1));
+
+    const auto key1 = cache.make_key(make_request(pbnavitia::places, "1", 0), 1);
+    const auto key2 = cache.make_key(make_request(pbnavitia::places, "1", 60), 1);
+    const auto key3 = cache.make_key(make_request(pbnavitia::places, "1", 120), 1);
+    cache.put(*key1, "0123456789", now);
+    cache.put(*key2, "0123456789", now);
+    BOOST_CHECK(cache.get(*key1, now)); // key2 is now the least recently used
+    cache.put(*key3, "0123456789", now);
+    BOOST_CHECK(cache.get(*key1, now));
+    BOOST_CHECK(! cache.get(*key2, now));
+    BOOST_CHECK(cache.get(*key3, now));
+    BOOST_CHECK_EQUAL(cache.size(), 2 * (key_size + 10));
+}
@@ -0,0 +1,87 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_rt_batch
+#include <boost/test/unit_test.hpp>
+#include "kraken/rt_batch.h"
+#include "type/datetime.h"
+#include "tests/utils_test.h"
+
+namespace ntest = navitia::test;
+
+BOOST_AUTO_TEST_CASE(coalesce_by_id_test) {
+    auto m1 = ntest::make_feed_message(1000);
+    ntest::add_trip_update(m1, "a", "vj:1");
+    ntest::add_trip_update(m1, "b", "vj:2");
+    auto m2 = ntest::make_feed_message(2000);
+    ntest::add_trip_update(m2, "a", "vj:1");
+    auto* deletion = m2.add_entity();
+    deletion->set_id("c");
+    deletion->set_is_deleted(true);
+    auto m3 = ntest::make_feed_message(3000);
+    ntest::add_trip_update(m3, "b", "vj:2");
+
+    const std::vector<std::string> bodies = {m1.SerializeAsString(), m2.SerializeAsString(),
+                                             m3.SerializeAsString()};
+    for (size_t nb_threads: {1, 2, 8}) {
+        const auto batch = navitia::parse_rt_batch(bodies, nb_threads);
+        BOOST_CHECK_EQUAL(batch.nb_invalid, 0);
+        BOOST_CHECK_EQUAL(batch.nb_entities, 5);
+        BOOST_CHECK_EQUAL(batch.nb_coalesced, 2);
+        // in the order of the last occurrences, with the timestamp of their feed
+        const std::vector<std::string> expected = {"a", "c", "b"};
+        const auto res = ntest::entity_ids(batch);
+        BOOST_CHECK_EQUAL_COLLECTIONS(res.begin(), res.end(), expected.begin(), expected.end());
+        BOOST_CHECK_EQUAL(batch.updates[0].timestamp, navitia::from_posix_timestamp(2000));
+        BOOST_CHECK_EQUAL(batch.updates[2].timestamp, navitia::from_posix_timestamp(3000));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(invalid_message_test) {
+    auto m1 = ntest::make_feed_message(1000);
+    ntest::add_trip_update(m1, "a", "vj:1");
+    auto m2 = ntest::make_feed_message(2000);
+    ntest::add_trip_update(m2, "b", "vj:2");
+
+    // an invalid message doesn't prevent the others to be applied
+    const auto batch = navitia::parse_rt_batch({m1.SerializeAsString(), "not a protobuf", m2.SerializeAsString()}, 2);
+    BOOST_CHECK_EQUAL(batch.nb_invalid, 1);
+    BOOST_CHECK_EQUAL(batch.nb_entities, 2);
+    BOOST_CHECK_EQUAL(batch.nb_coalesced, 0);
+    BOOST_REQUIRE_EQUAL(batch.updates.size(), 2);
+    BOOST_CHECK_EQUAL(batch.updates[1].entity->trip_update().trip().trip_id(), "vj:2");
+}
+
+BOOST_AUTO_TEST_CASE(empty_batch_test) {
+    const auto batch = navitia::parse_rt_batch({}, 4);
+    BOOST_CHECK(batch.updates.empty());
+    BOOST_CHECK_EQUAL(batch.nb_entities, 0);
+}
@@ -0,0 +1,74 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_rt_scheduler
+#include <boost/test/unit_test.hpp>
+#include "kraken/rt_scheduler.h"
+
+namespace pt = boost::posix_time;
+using navitia::kraken::RtScheduler;
+
+BOOST_AUTO_TEST_CASE(batch_size_from_costs_test) {
+    RtScheduler scheduler(pt::seconds(10), 5000);
+    // 2s of rebuild and 1ms by message: 8s are left, 4s to collect, 4s to apply
+    scheduler.record_batch(100, pt::milliseconds(100), pt::seconds(2));
+    BOOST_CHECK_EQUAL(scheduler.batch_size(), 4000);
+    BOOST_CHECK_EQUAL(scheduler.collect_window(), pt::seconds(4));
+    BOOST_CHECK_EQUAL(scheduler.idle_sleep(pt::seconds(1)), pt::seconds(1));
+    BOOST_CHECK_EQUAL(scheduler.idle_sleep(pt::seconds(10)), pt::seconds(4));
+
+    // the batches are capped
+    scheduler.record_batch(100, pt::milliseconds(1), pt::seconds(2));
+    BOOST_CHECK_EQUAL(scheduler.batch_size(), 5000);
+}
+
+BOOST_AUTO_TEST_CASE(moving_average_test) {
+    RtScheduler scheduler(pt::seconds(10), 5000);
+    scheduler.record_batch(10, pt::milliseconds(10), pt::seconds(1));
+    BOOST_CHECK_CLOSE(scheduler.rebuild_cost_us(), 1e6, 0.01);
+    scheduler.record_batch(10, pt::milliseconds(10), pt::seconds(2));
+    BOOST_CHECK(scheduler.rebuild_cost_us() > 1e6);
+    BOOST_CHECK(scheduler.rebuild_cost_us() < 2e6);
+    BOOST_CHECK_CLOSE(scheduler.message_cost_us(), 1000, 0.01);
+
+    // an empty batch tells nothing
+    scheduler.record_batch(0, pt::seconds(0), pt::seconds(10));
+    BOOST_CHECK(scheduler.rebuild_cost_us() < 2e6);
+}
+
+BOOST_AUTO_TEST_CASE(unreachable_target_test) {
+    RtScheduler scheduler(pt::seconds(1), 5000);
+    scheduler.record_batch(10, pt::milliseconds(10), pt::seconds(3));
+    // we can only keep up with the flow
+    BOOST_CHECK_EQUAL(scheduler.batch_size(), 5000);
+    BOOST_CHECK(scheduler.collect_window().is_pos_infinity());
+    BOOST_CHECK_EQUAL(scheduler.idle_sleep(pt::seconds(1)), pt::seconds(0));
+}
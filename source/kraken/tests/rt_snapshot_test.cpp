@@ -0,0 +1,137 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_rt_snapshot
+#include <boost/test/unit_test.hpp>
+#include "kraken/rt_snapshot.h"
+#include "type/datetime.h"
+#include "type/chaos.pb.h"
+#include "utils/exception.h"
+#include "tests/utils_test.h"
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+namespace ntest = navitia::test;
+
+struct snapshot_file {
+    const std::string path = (boost::filesystem::temp_directory_path()
+                              / boost::filesystem::unique_path("rt_snapshot_%%%%%%%%")).string();
+    ~snapshot_file() { boost::filesystem::remove(path); }
+};
+
+BOOST_FIXTURE_TEST_CASE(save_and_load_test, snapshot_file) {
+    navitia::RtSnapshot snapshot;
+    auto m1 = ntest::make_feed_message(1000);
+    ntest::add_trip_update(m1, "a", "vj:1");
+    ntest::add_trip_update(m1, "b", "vj:2");
+    ntest::add_trip_update(m1, "c", "vj:3");
+    snapshot.add(navitia::parse_rt_batch({m1.SerializeAsString()}, 1));
+    // a second batch updating a, then deleting c
+    auto m2 = ntest::make_feed_message(2000);
+    ntest::add_trip_update(m2, "a", "vj:1");
+    auto* deletion = m2.add_entity();
+    deletion->set_id("c");
+    deletion->set_is_deleted(true);
+    snapshot.add(navitia::parse_rt_batch({m2.SerializeAsString()}, 1));
+    // the deleted entity isn't kept
+    BOOST_CHECK_EQUAL(snapshot.size(), 2);
+
+    snapshot.save(path, {"kirin", "chaos"});
+    BOOST_CHECK(! navitia::rt_snapshot_time(path).is_not_a_date_time());
+    BOOST_CHECK(! boost::filesystem::exists(path + ".tmp"));
+
+    navitia::RtSnapshot loaded;
+    loaded.load(path);
+    BOOST_CHECK_EQUAL(loaded.size(), 2);
+    const std::vector<std::string> expected_topics = {"kirin", "chaos"};
+    BOOST_CHECK_EQUAL_COLLECTIONS(loaded.topics().begin(), loaded.topics().end(),
+                                  expected_topics.begin(), expected_topics.end());
+
+    // replaying the snapshot gives the entities in the order they were applied, with their timestamp
+    const auto batch = navitia::parse_rt_batch(loaded.messages(), 2);
+    BOOST_CHECK_EQUAL(batch.nb_coalesced, 0);
+    const std::vector<std::string> expected = {"b", "a"};
+    const auto res = ntest::entity_ids(batch);
+    BOOST_CHECK_EQUAL_COLLECTIONS(res.begin(), res.end(), expected.begin(), expected.end());
+    BOOST_CHECK_EQUAL(batch.updates[0].timestamp, navitia::from_posix_timestamp(1000));
+    BOOST_CHECK_EQUAL(batch.updates[1].timestamp, navitia::from_posix_timestamp(2000));
+}
+
+BOOST_AUTO_TEST_CASE(prune_test) {
+    navitia::RtSnapshot snapshot;
+    auto m = ntest::make_feed_message(1000);
+    ntest::add_trip_update(m, "trip_14", "vj:1");
+    m.mutable_entity(0)->mutable_trip_update()->mutable_trip()->set_start_date("20150314");
+    ntest::add_trip_update(m, "trip_15", "vj:1");
+    m.mutable_entity(1)->mutable_trip_update()->mutable_trip()->set_start_date("20150315");
+    // a disruption published until its end
+    auto* published = m.add_entity();
+    published->set_id("published");
+    auto* disruption = published->MutableExtension(chaos::disruption);
+    disruption->mutable_publication_period()->set_end(navitia::to_posix_timestamp("20150316T120000"_dt));
+    // a disruption without publication end lasts until its last impact
+    auto* applied = m.add_entity();
+    applied->set_id("applied");
+    disruption = applied->MutableExtension(chaos::disruption);
+    disruption->add_impacts()->add_application_periods()->set_end(navitia::to_posix_timestamp("20150318T000000"_dt));
+    // a disruption without end never expires
+    m.add_entity()->set_id("forever");
+    m.mutable_entity(4)->MutableExtension(chaos::disruption)->add_impacts()->add_application_periods();
+    snapshot.add(navitia::parse_rt_batch({m.SerializeAsString()}, 1));
+    BOOST_REQUIRE_EQUAL(snapshot.size(), 5);
+
+    // a trip update is kept 2 days after its start date
+    BOOST_CHECK_EQUAL(snapshot.prune("20150315T230000"_dt), 0);
+    BOOST_CHECK_EQUAL(snapshot.prune("20150316T010000"_dt), 1);
+    BOOST_CHECK_EQUAL(snapshot.prune("20150317T010000"_dt), 2);
+    BOOST_CHECK_EQUAL(snapshot.prune("20150318T010000"_dt), 1);
+    BOOST_CHECK_EQUAL(snapshot.prune("20300101T000000"_dt), 0);
+    const auto batch = navitia::parse_rt_batch(snapshot.messages(), 1);
+    const std::vector<std::string> expected = {"forever"};
+    const auto res = ntest::entity_ids(batch);
+    BOOST_CHECK_EQUAL_COLLECTIONS(res.begin(), res.end(), expected.begin(), expected.end());
+}
+
+BOOST_FIXTURE_TEST_CASE(invalid_snapshot_test, snapshot_file) {
+    navitia::RtSnapshot snapshot;
+    BOOST_CHECK(navitia::rt_snapshot_time(path).is_not_a_date_time());
+    BOOST_CHECK_THROW(snapshot.load(path), navitia::exception);
+
+    auto m = ntest::make_feed_message(1000);
+    ntest::add_trip_update(m, "a", "vj:1");
+    snapshot.add(navitia::parse_rt_batch({m.SerializeAsString()}, 1));
+    snapshot.save(path, {});
+    // a truncated file isn't partially loaded
+    boost::filesystem::resize_file(path, boost::filesystem::file_size(path) - 1);
+    navitia::RtSnapshot loaded;
+    BOOST_CHECK_THROW(loaded.load(path), navitia::exception);
+    BOOST_CHECK_EQUAL(loaded.size(), 0);
+}
@@ -0,0 +1,99 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_warm_up
+#include <boost/test/unit_test.hpp>
+#include "kraken/warm_up.h"
+#include "kraken/tests/journey_test_data.h"
+#include "utils/exception.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <boost/filesystem.hpp>
+#include <fstream>
+
+using namespace navitia::kraken;
+namespace pt = boost::posix_time;
+
+struct logger_initialized {
+    logger_initialized()   { init_logger(); }
+};
+BOOST_GLOBAL_FIXTURE( logger_initialized )
+
+static std::string write_log(const std::vector<std::string>& requests) {
+    const auto path = (boost::filesystem::temp_directory_path()
+                       / boost::filesystem::unique_path("warm_up_%%%%-%%%%.log")).string();
+    std::ofstream file(path, std::ios::binary);
+    google::protobuf::io::OstreamOutputStream raw_output(&file);
+    google::protobuf::io::CodedOutputStream output(&raw_output);
+    for (const auto& request: requests) {
+        output.WriteVarint32(request.size());
+        output.WriteString(request);
+    }
+    return path;
+}
+
+struct fixture: journey_data {
+    boost::shared_ptr<const navitia::type::Data> data;
+    std::vector<std::string> requests = {journey_request("B"), "this is not a protobuf", journey_request("B")};
+    std::string path;
+
+    fixture() {
+        data.reset(b.data.release());
+        path = write_log(requests);
+    }
+    ~fixture() { boost::filesystem::remove(path); }
+};
+
+BOOST_FIXTURE_TEST_CASE(read_request_log_test, fixture) {
+    BOOST_CHECK(read_request_log(path) == requests);
+}
+
+BOOST_AUTO_TEST_CASE(read_truncated_request_log) {
+    const auto path = write_log({"abc"});
+    // the size of the request is now wrong
+    boost::filesystem::resize_file(path, 3);
+    BOOST_CHECK_THROW(read_request_log(path), navitia::exception);
+    boost::filesystem::remove(path);
+    BOOST_CHECK_THROW(read_request_log(path), navitia::exception);
+}
+
+BOOST_FIXTURE_TEST_CASE(warm_up_test, fixture) {
+    const auto stats = warm_up(data, Configuration(), requests, 2, pt::seconds(60));
+    BOOST_CHECK_EQUAL(stats.nb_requests, 3);
+    BOOST_CHECK_EQUAL(stats.nb_errors, 1);
+    BOOST_CHECK_EQUAL(stats.nb_skipped, 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(warm_up_out_of_budget, fixture) {
+    const auto stats = warm_up(data, Configuration(), requests, 2, pt::seconds(-1));
+    BOOST_CHECK_EQUAL(stats.nb_requests, 0);
+    BOOST_CHECK_EQUAL(stats.nb_skipped, 3);
+}
@@ -0,0 +1,80 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE worker_classes_test
+#include <boost/test/unit_test.hpp>
+#include "kraken/worker_classes.h"
+#include "tests/utils_test.h"
+
+using namespace navitia::kraken;
+
+BOOST_AUTO_TEST_CASE(parse_worker_classes_test) {
+    const auto classes = parse_worker_classes({"journeys:4:50:PLANNER,pt_planner,heat_map",
+                                               "autocomplete:2:0:places"}, 8, 100);
+    BOOST_REQUIRE_EQUAL(classes.size(), 3);
+    BOOST_CHECK_EQUAL(classes[0].name, "default");
+    BOOST_CHECK_EQUAL(classes[0].nb_threads, 8);
+    BOOST_CHECK_EQUAL(classes[0].max_queue, 100);
+    BOOST_CHECK(classes[0].apis.empty());
+
+    BOOST_CHECK_EQUAL(classes[1].name, "journeys");
+    BOOST_CHECK_EQUAL(classes[1].nb_threads, 4);
+    BOOST_CHECK_EQUAL(classes[1].max_queue, 50);
+    BOOST_CHECK_EQUAL(classes[1].apis.size(), 3);
+    BOOST_CHECK(classes[1].apis.count(pbnavitia::heat_map));
+    BOOST_CHECK_EQUAL(classes[1].socket_path(), "inproc://workers_journeys");
+
+    BOOST_CHECK_EQUAL(classes[2].name, "autocomplete");
+    BOOST_CHECK_EQUAL(classes[2].max_queue, 0);
+    BOOST_CHECK(classes[2].apis.count(pbnavitia::places));
+}
+
+BOOST_AUTO_TEST_CASE(parse_invalid_worker_classes_test) {
+    BOOST_CHECK_THROW(parse_worker_classes({"journeys:4:PLANNER"}, 1, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_worker_classes({"journeys:0:10:PLANNER"}, 1, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_worker_classes({"journeys:a:10:PLANNER"}, 1, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_worker_classes({"journeys:1:10:NOT_AN_API"}, 1, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(parse_worker_classes({"a:1:10:PLANNER", "b:1:10:PLANNER"}, 1, 0),
+                      std::invalid_argument);
+    BOOST_CHECK_THROW(parse_worker_classes({"default:1:10:PLANNER"}, 1, 0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(peek_requested_api_test) {
+    pbnavitia::Request request;
+    request.set_request_id("a request id");
+    request.set_requested_api(pbnavitia::places);
+    const std::string buf = request.SerializeAsString();
+    BOOST_CHECK_EQUAL(peek_requested_api(buf.data(), buf.size()), pbnavitia::places);
+
+    const std::string garbage = "not a protobuf";
+    BOOST_CHECK_EQUAL(peek_requested_api(garbage.data(), garbage.size()), pbnavitia::UNKNOWN_API);
+    BOOST_CHECK_EQUAL(peek_requested_api(nullptr, 0), pbnavitia::UNKNOWN_API);
+}
@@ -0,0 +1,95 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "warm_up.h"
+#include "kraken/batch_runner.h"
+#include "kraken/data_manager.h"
+#include "utils/exception.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <algorithm>
+#include <fstream>
+
+namespace pt = boost::posix_time;
+
+namespace navitia { namespace kraken {
+
+std::vector<std::string> read_request_log(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (! file) {
+        throw navitia::exception("impossible to open the requests file " + path);
+    }
+    google::protobuf::io::IstreamInputStream raw_input(&file);
+    std::vector<std::string> requests;
+    while (true) {
+        // a CodedInputStream per request, they have a limit on the total size read
+        google::protobuf::io::CodedInputStream input(&raw_input);
+        uint32_t size;
+        if (! input.ReadVarint32(&size)) { break; }
+        std::string request;
+        if (! input.ReadString(&request, int(size))) {
+            throw navitia::exception("truncated request in " + path);
+        }
+        requests.push_back(std::move(request));
+    }
+    return requests;
+}
+
+WarmUpStats warm_up(const boost::shared_ptr<const type::Data>& data,
+                    const Configuration& conf,
+                    const std::vector<std::string>& requests,
+                    int nb_threads,
+                    const pt::time_duration& budget) {
+    const auto start = pt::microsec_clock::universal_time();
+    WarmUpStats stats;
+    // the new data isn't in the main data manager yet
+    DataManager<type::Data> warm_up_data;
+    warm_up_data.set_data(boost::shared_ptr<const type::Data>(data));
+    BatchRunner runner(warm_up_data, conf, nb_threads);
+
+    // small chunks, to check the budget regularly
+    const size_t chunk_size = 8 * size_t(std::max(nb_threads, 1));
+    for (auto it = requests.begin(); it != requests.end();) {
+        if (pt::microsec_clock::universal_time() - start > budget) {
+            stats.nb_skipped = requests.end() - it;
+            break;
+        }
+        const auto end = it + std::min(chunk_size, size_t(requests.end() - it));
+        for (const auto& response: runner.run(std::vector<std::string>(it, end))) {
+            ++stats.nb_requests;
+            if (response.has_error()) { ++stats.nb_errors; }
+        }
+        it = end;
+    }
+    stats.duration = pt::microsec_clock::universal_time() - start;
+    return stats;
+}
+
+}} // namespace navitia::kraken
@@ -0,0 +1,72 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "kraken/configuration.h"
+#include "type/data.h"
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+namespace navitia { namespace kraken {
+
+/**
+ * Read a file of recorded requests
+ *
+ * Each request is its size, as a varint, followed by the serialized
+ * pbnavitia::Request (the "delimited" format of protobuf).
+ */
+std::vector<std::string> read_request_log(const std::string& path);
+
+struct WarmUpStats {
+    size_t nb_requests = 0;
+    /// requests answered by an error, e.g. an unknown stop area
+    size_t nb_errors = 0;
+    /// requests not replayed, the budget being exhausted
+    size_t nb_skipped = 0;
+    boost::posix_time::time_duration duration;
+};
+
+/**
+ * Replay the requests on a freshly loaded data before it is used
+ *
+ * The caches of the data (next stop times, ...) and the pages of its
+ * memory are then hot when the traffic comes. The replay stops when
+ * the budget is exhausted.
+ */
+WarmUpStats warm_up(const boost::shared_ptr<const type::Data>& data,
+                    const Configuration& conf,
+                    const std::vector<std::string>& requests,
+                    int nb_threads,
+                    const boost::posix_time::time_duration& budget);
+
+}} // namespace navitia::kraken
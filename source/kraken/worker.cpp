@@ -170,7 +170,8 @@ std::vector<std::string> vector_of_admins(const T & admin){
 
 Worker::Worker(DataManager<navitia::type::Data>& data_manager, kraken::Configuration conf) :
     data_manager(data_manager), conf(conf),
-    logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"))){}
+    logger(log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"))),
+    trace_sampler(std::max(0, conf.trace_sampling())){}
 
 Worker::~Worker(){}
 
@@ -293,7 +294,7 @@ void Worker::init_worker_data(const boost::shared_ptr<const navitia::type::Data>
     //@TODO should be done in data_manager
     if(data->data_identifier != this->last_data_identifier || !planner){
         planner = std::make_unique<routing::RAPTOR>(*data);
-        street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref);
+        street_network_worker = std::make_unique<georef::StreetNetwork>(*data->geo_ref, *data->projected_stop_points);
         this->last_data_identifier = data->data_identifier;
 
         LOG4CPLUS_INFO(logger, "Instanciate planner");
@@ -665,6 +666,7 @@ pbnavitia::Response Worker::err_msg_isochron(const std::string& err_msg, navitia
 
 pbnavitia::Response Worker::journeys(const pbnavitia::JourneysRequest &request, pbnavitia::API api,
                                      const boost::posix_time::ptime& current_datetime) {
+    tracing::Span span("worker.journeys");
     try{
         const auto data = data_manager.get_data();
         this->init_worker_data(data);
@@ -900,45 +902,52 @@ pbnavitia::Response Worker::dispatch(const pbnavitia::Request& request) {
         fill_pb_error(pbnavitia::Error::service_unavailable, "The service is loading data", response.mutable_error());
         return response;
     }
-    boost::posix_time::ptime current_datetime = bt::from_time_t(request._current_datetime());
+    ArenaScope arena_scope(arena);
+    tracing::Scope trace_scope(trace_sampler.sample());
+    tracing::Span span(pbnavitia::API_Name(request.requested_api()).c_str());
+    // the response is built in place: a protobuf copy of a whole journey
+    // response is expensive, and older protobuf have no move
+    pbnavitia::Response api_response = dispatch_api(request, bt::from_time_t(request._current_datetime()));
+    metadatas(api_response);//we add the metadatas for each response
+    feed_publisher(api_response);
+    return api_response;
+}
+
+pbnavitia::Response Worker::dispatch_api(const pbnavitia::Request& request,
+                                         const boost::posix_time::ptime& current_datetime) {
     switch(request.requested_api()){
-    case pbnavitia::places: response = autocomplete(request.places(), current_datetime); break;
-    case pbnavitia::pt_objects: response = pt_object(request.pt_objects(), current_datetime); break;
-    case pbnavitia::place_uri: response = place_uri(request.place_uri(), current_datetime); break;
+    case pbnavitia::places: return autocomplete(request.places(), current_datetime);
+    case pbnavitia::pt_objects: return pt_object(request.pt_objects(), current_datetime);
+    case pbnavitia::place_uri: return place_uri(request.place_uri(), current_datetime);
     case pbnavitia::ROUTE_SCHEDULES:
     case pbnavitia::NEXT_DEPARTURES:
     case pbnavitia::NEXT_ARRIVALS:
     case pbnavitia::PREVIOUS_DEPARTURES:
     case pbnavitia::PREVIOUS_ARRIVALS:
     case pbnavitia::DEPARTURE_BOARDS:
-        response = next_stop_times(request.next_stop_times(), request.requested_api(), current_datetime); break;
+        return next_stop_times(request.next_stop_times(), request.requested_api(), current_datetime);
     case pbnavitia::ISOCHRONE:
     case pbnavitia::NMPLANNER:
     case pbnavitia::pt_planner:
-    case pbnavitia::PLANNER: response = journeys(request.journeys(), request.requested_api(),
-                                                 current_datetime); break;
-    case pbnavitia::places_nearby: response = proximity_list(request.places_nearby(), current_datetime); break;
-    case pbnavitia::PTREFERENTIAL: response = pt_ref(request.ptref(), current_datetime); break;
-    case pbnavitia::traffic_reports : response = traffic_reports(request.traffic_reports(),
-                                                                 current_datetime); break;
-    case pbnavitia::calendars : response = calendars(request.calendars(), current_datetime); break;
-    case pbnavitia::place_code : response = place_code(request.place_code()); break;
-    case pbnavitia::nearest_stop_points : response = nearest_stop_points(request.nearest_stop_points()); break;
-    case pbnavitia::geo_status: response = geo_status(); break;
-    case pbnavitia::car_co2_emission:
-        response = car_co2_emission_on_crow_fly(request.car_co2_emission()); break;
-    case pbnavitia::direct_path:
-        response = direct_path(request); break;
-    case pbnavitia::graphical_isochrone: response = graphical_isochrone(request.isochrone(), current_datetime); break;
-    case pbnavitia::heat_map: response = heat_map(request.heat_map(), current_datetime); break;
-    default:
+    case pbnavitia::PLANNER: return journeys(request.journeys(), request.requested_api(), current_datetime);
+    case pbnavitia::places_nearby: return proximity_list(request.places_nearby(), current_datetime);
+    case pbnavitia::PTREFERENTIAL: return pt_ref(request.ptref(), current_datetime);
+    case pbnavitia::traffic_reports : return traffic_reports(request.traffic_reports(), current_datetime);
+    case pbnavitia::calendars : return calendars(request.calendars(), current_datetime);
+    case pbnavitia::place_code : return place_code(request.place_code());
+    case pbnavitia::nearest_stop_points : return nearest_stop_points(request.nearest_stop_points());
+    case pbnavitia::geo_status: return geo_status();
+    case pbnavitia::car_co2_emission: return car_co2_emission_on_crow_fly(request.car_co2_emission());
+    case pbnavitia::direct_path: return direct_path(request);
+    case pbnavitia::graphical_isochrone: return graphical_isochrone(request.isochrone(), current_datetime);
+    case pbnavitia::heat_map: return heat_map(request.heat_map(), current_datetime);
+    default: {
         LOG4CPLUS_WARN(logger, "Unknown API : " + API_Name(request.requested_api()));
+        pbnavitia::Response response;
         fill_pb_error(pbnavitia::Error::unknown_api, "Unknown API", response.mutable_error());
-        break;
+        return response;
+    }
     }
-    metadatas(response);//we add the metadatas for each response
-    feed_publisher(response);
-    return response;
 }
 
 pbnavitia::Response Worker::nearest_stop_points(const pbnavitia::NearestStopPointsRequest& request) {
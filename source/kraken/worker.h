@@ -45,6 +45,8 @@ namespace routing{
 #include "utils/logger.h"
 #include "kraken/configuration.h"
 #include "type/pb_converter.h"
+#include "type/arena.h"
+#include "type/tracing.h"
 
 #include <memory>
 #include <limits>
@@ -78,6 +80,9 @@ class Worker {
         log4cplus::Logger logger;
         size_t last_data_identifier = std::numeric_limits<size_t>::max();// to check that data did not change, do not use directly
         boost::posix_time::ptime last_load_at;
+        // temporaries of the current request, kept from one request to the next
+        Arena arena;
+        tracing::Sampler trace_sampler;
 
     public:
         Worker(DataManager<navitia::type::Data>& data_manager, kraken::Configuration conf);
@@ -125,6 +130,10 @@ class Worker {
                                      const boost::posix_time::ptime& current_datetime);
         pbnavitia::Response car_co2_emission_on_crow_fly(const pbnavitia::CarCO2EmissionRequest& request);
         pbnavitia::Response direct_path(const pbnavitia::Request& request);
+
+    private:
+        pbnavitia::Response dispatch_api(const pbnavitia::Request& request,
+                                         const boost::posix_time::ptime& current_datetime);
 };
 
 }
@@ -0,0 +1,314 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "worker_classes.h"
+#include "utils/zmq.h"
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/wire_format_lite.h>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cassert>
+#include <stdexcept>
+
+namespace pt = boost::posix_time;
+using google::protobuf::internal::WireFormatLite;
+
+namespace navitia { namespace kraken {
+
+std::vector<WorkerClass> parse_worker_classes(const std::vector<std::string>& confs,
+                                              int default_nb_threads,
+                                              size_t default_max_queue) {
+    std::vector<WorkerClass> res(1);
+    res[0].name = "default";
+    res[0].nb_threads = default_nb_threads;
+    res[0].max_queue = default_max_queue;
+
+    std::set<pbnavitia::API> used_apis;
+    for (const auto& conf: confs) {
+        std::vector<std::string> fields;
+        boost::split(fields, conf, boost::is_any_of(":"));
+        if (fields.size() != 4) {
+            throw std::invalid_argument("invalid worker class \"" + conf
+                                        + "\", expected name:nb_threads:max_queue:API,API...");
+        }
+        WorkerClass worker_class;
+        worker_class.name = fields[0];
+        for (const auto& other: res) {
+            if (other.name == worker_class.name) {
+                throw std::invalid_argument("duplicated worker class " + worker_class.name);
+            }
+        }
+        try {
+            worker_class.nb_threads = boost::lexical_cast<int>(fields[1]);
+            worker_class.max_queue = boost::lexical_cast<size_t>(fields[2]);
+        } catch (const boost::bad_lexical_cast&) {
+            throw std::invalid_argument("invalid number in worker class \"" + conf + "\"");
+        }
+        if (worker_class.nb_threads < 1) {
+            throw std::invalid_argument("worker class " + worker_class.name + " must have a thread");
+        }
+        std::vector<std::string> api_names;
+        boost::split(api_names, fields[3], boost::is_any_of(","));
+        for (const auto& api_name: api_names) {
+            pbnavitia::API api;
+            if (! pbnavitia::API_Parse(api_name, &api)) {
+                throw std::invalid_argument("unknown api " + api_name + " in worker class " + worker_class.name);
+            }
+            if (! used_apis.insert(api).second) {
+                throw std::invalid_argument("api " + api_name + " is in several worker classes");
+            }
+            worker_class.apis.insert(api);
+        }
+        res.push_back(std::move(worker_class));
+    }
+    return res;
+}
+
+pbnavitia::API peek_requested_api(const void* data, size_t size) {
+    google::protobuf::io::CodedInputStream input(static_cast<const uint8_t*>(data), int(size));
+    while (const uint32_t tag = input.ReadTag()) {
+        if (WireFormatLite::GetTagFieldNumber(tag) == pbnavitia::Request::kRequestedApiFieldNumber
+                && WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_VARINT) {
+            uint32_t value;
+            if (input.ReadVarint32(&value) && pbnavitia::API_IsValid(value)) {
+                return pbnavitia::API(value);
+            }
+            break;
+        }
+        if (! WireFormatLite::SkipField(&input, tag)) { break; }
+    }
+    return pbnavitia::UNKNOWN_API;
+}
+
+pbnavitia::Response make_overloaded_response(const WorkerClass& worker_class) {
+    pbnavitia::Response response;
+    response.mutable_error()->set_id(pbnavitia::Error::service_unavailable);
+    response.mutable_error()->set_message("kraken is overloaded: the queue of the "
+                                          + worker_class.name + " workers is full");
+    return response;
+}
+
+bool has_more_frames(zmq::socket_t& socket) {
+    int more = 0;
+    size_t more_size = sizeof(more);
+    socket.getsockopt(ZMQ_RCVMORE, &more, &more_size);
+    return more != 0;
+}
+
+void forward_batch(zmq::socket_t& clients, zmq::socket_t* batches,
+                   const std::string& client, zmq::message_t first_request) {
+    std::vector<zmq::message_t> requests;
+    requests.push_back(std::move(first_request));
+    do {
+        requests.emplace_back();
+        clients.recv(&requests.back());
+    } while (has_more_frames(clients));
+
+    if (! batches) {
+        // one error per request, the reply has the shape of a batch reply
+        pbnavitia::Response response;
+        response.mutable_error()->set_id(pbnavitia::Error::service_unavailable);
+        response.mutable_error()->set_message("the batches of requests are disabled on this kraken");
+        z_send(clients, client, ZMQ_SNDMORE);
+        z_send(clients, "", ZMQ_SNDMORE);
+        for (size_t i = 0; i < requests.size(); ++i) {
+            zmq::message_t reply(response.ByteSize());
+            response.SerializeToArray(reply.data(), reply.size());
+            clients.send(reply, i + 1 < requests.size() ? ZMQ_SNDMORE : 0);
+        }
+        return;
+    }
+    z_send(*batches, client, ZMQ_SNDMORE);
+    z_send(*batches, "", ZMQ_SNDMORE);
+    for (size_t i = 0; i < requests.size(); ++i) {
+        batches->send(requests[i], i + 1 < requests.size() ? ZMQ_SNDMORE : 0);
+    }
+}
+
+void forward_batch_reply(zmq::socket_t& batches, zmq::socket_t& clients) {
+    const std::string client = z_recv(batches);
+    {
+        std::string empty = z_recv(batches);
+        assert(empty.size() == 0);
+    }
+    z_send(clients, client, ZMQ_SNDMORE);
+    z_send(clients, "", ZMQ_SNDMORE);
+    bool more = true;
+    while (more) {
+        zmq::message_t frame;
+        batches.recv(&frame);
+        more = has_more_frames(batches);
+        clients.send(frame, more ? ZMQ_SNDMORE : 0);
+    }
+}
+
+ClassLoadBalancer::Pool::Pool(zmq::context_t& context, WorkerClass c):
+    worker_class(std::move(c)), workers(context, ZMQ_ROUTER) {}
+
+ClassLoadBalancer::ClassLoadBalancer(zmq::context_t& context, const std::vector<WorkerClass>& classes,
+                                     bool with_batches):
+    clients(context, ZMQ_ROUTER), last_report(pt::microsec_clock::universal_time()) {
+    for (const auto& worker_class: classes) {
+        pools.push_back(std::make_unique<Pool>(context, worker_class));
+    }
+    if (with_batches) {
+        batches = std::make_unique<zmq::socket_t>(context, ZMQ_PAIR);
+    }
+}
+
+void ClassLoadBalancer::bind(const std::string& clients_socket_path) {
+    clients.bind(clients_socket_path.c_str());
+    for (auto& pool: pools) {
+        pool->workers.bind(pool->worker_class.socket_path().c_str());
+    }
+    if (batches) {
+        batches->bind(batches_socket_path().c_str());
+    }
+}
+
+size_t ClassLoadBalancer::find_pool(pbnavitia::API api) const {
+    for (size_t i = 1; i < pools.size(); ++i) {
+        if (pools[i]->worker_class.apis.count(api)) { return i; }
+    }
+    return 0;
+}
+
+void ClassLoadBalancer::send_to_worker(Pool& pool, const std::string& worker, Pending& pending) {
+    if (recorder) {
+        recorder->record_queue_wait(pending.api, pt::microsec_clock::universal_time() - pending.received_at);
+    }
+    z_send(pool.workers, worker, ZMQ_SNDMORE);
+    z_send(pool.workers, "", ZMQ_SNDMORE);
+    z_send(pool.workers, pending.client, ZMQ_SNDMORE);
+    z_send(pool.workers, "", ZMQ_SNDMORE);
+    pool.workers.send(pending.request);
+}
+
+void ClassLoadBalancer::handle_client() {
+    Pending pending;
+    pending.client = z_recv(clients);
+    {
+        std::string empty = z_recv(clients);
+        assert(empty.size() == 0);
+    }
+    clients.recv(&pending.request);
+    if (has_more_frames(clients)) {
+        forward_batch(clients, batches.get(), pending.client, std::move(pending.request));
+        return;
+    }
+
+    pending.api = peek_requested_api(pending.request.data(), pending.request.size());
+    pending.received_at = pt::microsec_clock::universal_time();
+    auto& pool = *pools[find_pool(pending.api)];
+    if (! pool.available_workers.empty()) {
+        const std::string worker = pool.available_workers.front();
+        pool.available_workers.pop_front();
+        send_to_worker(pool, worker, pending);
+        return;
+    }
+    if (pool.worker_class.max_queue != 0 && pool.queue.size() >= pool.worker_class.max_queue) {
+        // admission control: better a fast error than a timeout
+        ++pool.nb_rejected;
+        const auto response = make_overloaded_response(pool.worker_class);
+        zmq::message_t reply(response.ByteSize());
+        response.SerializeToArray(reply.data(), reply.size());
+        z_send(clients, pending.client, ZMQ_SNDMORE);
+        z_send(clients, "", ZMQ_SNDMORE);
+        clients.send(reply);
+        return;
+    }
+    pool.queue.push_back(std::move(pending));
+}
+
+void ClassLoadBalancer::handle_worker(Pool& pool) {
+    const std::string worker = z_recv(pool.workers);
+    {
+        std::string empty = z_recv(pool.workers);
+        assert(empty.size() == 0);
+    }
+    const std::string client = z_recv(pool.workers);
+    if (client != "READY") {
+        {
+            std::string empty = z_recv(pool.workers);
+            assert(empty.size() == 0);
+        }
+        zmq::message_t reply;
+        pool.workers.recv(&reply);
+        z_send(clients, client, ZMQ_SNDMORE);
+        z_send(clients, "", ZMQ_SNDMORE);
+        clients.send(reply);
+    }
+    if (pool.queue.empty()) {
+        pool.available_workers.push_back(worker);
+    } else {
+        Pending pending = std::move(pool.queue.front());
+        pool.queue.pop_front();
+        send_to_worker(pool, worker, pending);
+    }
+}
+
+void ClassLoadBalancer::report() {
+    const auto now = pt::microsec_clock::universal_time();
+    if (now - last_report < pt::minutes(1)) { return; }
+    last_report = now;
+    for (auto& pool: pools) {
+        const auto& worker_class = pool->worker_class;
+        LOG4CPLUS_INFO(logger, "worker class " << worker_class.name
+                       << ": queue depth " << pool->queue.size()
+                       << ", busy workers " << worker_class.nb_threads - int(pool->available_workers.size())
+                       << "/" << worker_class.nb_threads
+                       << ", rejected requests " << pool->nb_rejected);
+        pool->nb_rejected = 0;
+    }
+}
+
+void ClassLoadBalancer::run() {
+    std::vector<zmq::pollitem_t> items;
+    items.push_back({static_cast<void*>(clients), 0, ZMQ_POLLIN, 0});
+    for (auto& pool: pools) {
+        items.push_back({static_cast<void*>(pool->workers), 0, ZMQ_POLLIN, 0});
+    }
+    if (batches) {
+        items.push_back({static_cast<void*>(*batches), 0, ZMQ_POLLIN, 0});
+    }
+    while (true) {
+        zmq::poll(items.data(), int(items.size()), 1000);
+        // the replies first, they free workers for the queued requests
+        for (size_t i = 0; i < pools.size(); ++i) {
+            if (items[i + 1].revents & ZMQ_POLLIN) { handle_worker(*pools[i]); }
+        }
+        if (batches && (items.back().revents & ZMQ_POLLIN)) { forward_batch_reply(*batches, clients); }
+        if (items[0].revents & ZMQ_POLLIN) { handle_client(); }
+        report();
+    }
+}
+
+}} // namespace navitia::kraken
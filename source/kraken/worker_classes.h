@@ -0,0 +1,148 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/request.pb.h"
+#include "type/response.pb.h"
+#include "kraken/metrics.h"
+#include "utils/logger.h"
+#include <zmq.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <deque>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace navitia { namespace kraken {
+
+/**
+ * A pool of workers dedicated to a family of apis
+ *
+ * Each class has its own threads and its own queue, thus a burst of
+ * heavy requests (journeys, isochrones) doesn't delay the cheap ones
+ * (autocomplete, status).
+ */
+struct WorkerClass {
+    std::string name;
+    int nb_threads = 1;
+    /// max number of queued requests, the other ones are rejected
+    size_t max_queue = 0;
+    /// the apis of the class, empty for the default class
+    std::set<pbnavitia::API> apis;
+
+    std::string socket_path() const { return "inproc://workers_" + name; }
+};
+
+/**
+ * Parse the worker classes of the configuration
+ *
+ * Each class is "name:nb_threads:max_queue:API,API...", the API being the
+ * names of pbnavitia::API. The first returned class is the "default"
+ * one, with default_nb_threads, it handles the apis of no class.
+ */
+std::vector<WorkerClass> parse_worker_classes(const std::vector<std::string>& confs,
+                                              int default_nb_threads,
+                                              size_t default_max_queue);
+
+/// requested_api of a serialized pbnavitia::Request, without parsing the whole request
+pbnavitia::API peek_requested_api(const void* data, size_t size);
+
+/// The response sent when a class queue is full
+pbnavitia::Response make_overloaded_response(const WorkerClass&);
+
+/// true if the last frame received on the socket is followed by others
+bool has_more_frames(zmq::socket_t& socket);
+
+/// The socket between the load balancer and the BatchRunner
+inline std::string batches_socket_path() { return "inproc://batches"; }
+
+/**
+ * Forward to the BatchRunner a batch whose first request is received
+ *
+ * Without batches socket, an error is answered for each request.
+ */
+void forward_batch(zmq::socket_t& clients, zmq::socket_t* batches,
+                   const std::string& client, zmq::message_t first_request);
+
+/// Forward a reply of the BatchRunner to its client
+void forward_batch_reply(zmq::socket_t& batches, zmq::socket_t& clients);
+
+/**
+ * Load balancer routing the requests to the worker classes
+ *
+ * Same protocol as utils' LoadBalancer: the workers of a class connect
+ * a REQ socket to the socket_path() of their class and send READY.
+ *
+ * A client message with several request frames is a batch, it is given
+ * as a whole to the BatchRunner connected to batches_socket_path().
+ */
+class ClassLoadBalancer {
+    struct Pending {
+        std::string client;
+        zmq::message_t request;
+        pbnavitia::API api = pbnavitia::UNKNOWN_API;
+        boost::posix_time::ptime received_at;
+    };
+    struct Pool {
+        WorkerClass worker_class;
+        zmq::socket_t workers;
+        std::deque<std::string> available_workers;
+        std::deque<Pending> queue;
+        size_t nb_rejected = 0;
+        Pool(zmq::context_t& context, WorkerClass c);
+    };
+
+    zmq::socket_t clients;
+    std::vector<std::unique_ptr<Pool>> pools;
+    /// null when the batches are disabled
+    std::unique_ptr<zmq::socket_t> batches;
+    log4cplus::Logger logger = log4cplus::Logger::getInstance("load_balancer");
+    boost::posix_time::ptime last_report;
+    Metrics::Recorder* recorder = nullptr;
+
+    size_t find_pool(pbnavitia::API api) const;
+    void handle_client();
+    void handle_worker(Pool& pool);
+    void send_to_worker(Pool& pool, const std::string& worker, Pending& pending);
+    void report();
+
+public:
+    ClassLoadBalancer(zmq::context_t& context, const std::vector<WorkerClass>& classes,
+                      bool with_batches = false);
+
+    void bind(const std::string& clients_socket_path);
+    /// record the time spent by the requests in the queues
+    void set_metrics(Metrics& metrics) { recorder = &metrics.new_recorder(); }
+    void run();
+};
+
+}} // namespace navitia::kraken
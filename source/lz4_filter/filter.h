@@ -34,9 +34,21 @@ www.navitia.io
 #include <string.h>
 #include <iostream>
 #include "third_party/lz4/lz4.h"
+#include "third_party/lz4/lz4hc.h"
+#include "utils/exception.h"
 #include <boost/iostreams/write.hpp>
 #include <boost/iostreams/read.hpp>
 #include <boost/cstdint.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 typedef std::exception LZ4Exception;
 
@@ -138,3 +150,278 @@ public:
     }
 };
 
+
+namespace lz4_detail {
+
+/// Fixed size pool of threads (de)compressing the chunks
+class ThreadPool {
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<std::function<void()>> jobs;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+
+    void run() {
+        while (true) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [&]() { return stopping || ! jobs.empty(); });
+                if (jobs.empty()) { return; }
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t nb_threads) {
+        for (size_t i = 0; i < nb_threads; ++i) {
+            workers.emplace_back([this]() { run(); });
+        }
+    }
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cond.notify_all();
+        for (auto& worker: workers) { worker.join(); }
+    }
+
+    size_t size() const { return workers.size(); }
+
+    /// the exceptions of f are rethrown by get() on the returned future
+    template<typename F>
+    std::future<std::string> submit(F f) {
+        auto task = std::make_shared<std::packaged_task<std::string()>>(std::move(f));
+        auto result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.emplace_back([task]() { (*task)(); });
+        }
+        cond.notify_one();
+        return result;
+    }
+};
+
+inline size_t default_nb_threads() {
+    const size_t nb = std::thread::hardware_concurrency();
+    return nb ? nb : 1;
+}
+
+/// read exactly size bytes, unless the end of the stream is reached
+template<typename Source>
+std::streamsize read_all(Source& src, char* dest, std::streamsize size) {
+    std::streamsize total = 0;
+    while (total < size) {
+        const std::streamsize nb = boost::iostreams::read(src, dest + total, size - total);
+        if (nb <= 0) { break; }
+        total += nb;
+    }
+    return total;
+}
+
+// each chunk is written as: raw size, compressed size (little endian
+// uint32), compressed data
+const size_t chunk_header_size = 2 * sizeof(uint32_t);
+// bounds what is allocated for a chunk of a corrupted stream
+const uint32_t max_chunk_size = 64 * 1024 * 1024;
+
+inline void write_le32(char* dest, uint32_t val) {
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        dest[i] = char(val & 0xFF);
+        val >>= 8;
+    }
+}
+
+inline uint32_t read_le32(const char* src) {
+    uint32_t val = 0;
+    for (size_t i = 0; i < sizeof(uint32_t); ++i) {
+        val |= uint32_t(uint8_t(src[i])) << (8 * i);
+    }
+    return val;
+}
+
+} // namespace lz4_detail
+
+
+/**
+ * Compression filter writing chunks that can be decompressed in
+ * parallel by LZ4ParallelDecompressor.
+ *
+ * The chunks are compressed by a pool of threads, and written in order
+ * as soon as they are ready.  This format is not readable by
+ * LZ4Decompressor.
+ */
+class LZ4ParallelCompressor : public boost::iostreams::multichar_output_filter {
+    struct State {
+        lz4_detail::ThreadPool pool;
+        std::deque<std::future<std::string>> pending;
+        std::string chunk;
+        explicit State(size_t nb_threads): pool(nb_threads) {}
+    };
+    std::streamsize chunk_size;
+    bool high_compression;
+    size_t nb_threads;
+    std::unique_ptr<State> state;
+
+    template<typename Sink>
+    void write_front(Sink& dest) {
+        const std::string compressed = state->pending.front().get();
+        state->pending.pop_front();
+        boost::iostreams::write(dest, compressed.data(), compressed.size());
+    }
+
+    template<typename Sink>
+    void submit_chunk(Sink& dest) {
+        // bound the memory used by the chunks waiting to be written
+        if (state->pending.size() >= 2 * nb_threads) { write_front(dest); }
+        const bool hc = high_compression;
+        // shared, the job is copied in a std::function
+        const auto chunk_ptr = std::make_shared<std::string>(std::move(state->chunk));
+        state->pending.push_back(state->pool.submit([hc, chunk_ptr]() {
+            const std::string& chunk = *chunk_ptr;
+            const size_t header_size = lz4_detail::chunk_header_size;
+            std::string out(header_size + LZ4_compressBound(chunk.size()), '\0');
+            const int size = hc ? LZ4_compressHC(chunk.data(), &out[header_size], chunk.size())
+                                : LZ4_compress(chunk.data(), &out[header_size], chunk.size());
+            if (size <= 0) { throw LZ4Exception(); }
+            lz4_detail::write_le32(&out[0], uint32_t(chunk.size()));
+            lz4_detail::write_le32(&out[sizeof(uint32_t)], uint32_t(size));
+            out.resize(header_size + size);
+            return out;
+        }));
+        state->chunk.clear();
+    }
+
+public:
+    /**
+     * @param chunk_size taille des chunks décompressés, au plus lz4_detail::max_chunk_size
+     * @param high_compression utilise LZ4HC: compression plus lente, fichier plus petit,
+     * la décompression est aussi rapide
+     * @param nb_threads nombre de threads de compression
+     */
+    LZ4ParallelCompressor(std::streamsize chunk_size = 1024*1024,
+                          bool high_compression = false,
+                          size_t nb_threads = lz4_detail::default_nb_threads()):
+        chunk_size(std::min<std::streamsize>(chunk_size, lz4_detail::max_chunk_size)),
+        high_compression(high_compression), nb_threads(nb_threads) {}
+
+    LZ4ParallelCompressor(const LZ4ParallelCompressor& other):
+        chunk_size(other.chunk_size), high_compression(other.high_compression),
+        nb_threads(other.nb_threads) {}
+
+    template<typename Sink>
+    std::streamsize write(Sink& dest, const char* src, std::streamsize size) {
+        if (! state) {
+            state.reset(new State(nb_threads));
+            state->chunk.reserve(chunk_size);
+        }
+        const std::streamsize nb = std::min<std::streamsize>(size, chunk_size - state->chunk.size());
+        state->chunk.append(src, nb);
+        if (std::streamsize(state->chunk.size()) == chunk_size) { submit_chunk(dest); }
+        return nb;
+    }
+
+    template<typename Sink>
+    void close(Sink& dest) {
+        if (! state) { return; }
+        if (! state->chunk.empty()) { submit_chunk(dest); }
+        while (! state->pending.empty()) { write_front(dest); }
+        state.reset();
+    }
+};
+
+/**
+ * Decompression filter of the LZ4ParallelCompressor format.
+ *
+ * The next chunks are read ahead and decompressed by a pool of threads
+ * while the previous ones are consumed.
+ */
+class LZ4ParallelDecompressor : public boost::iostreams::multichar_input_filter {
+    struct State {
+        std::shared_ptr<lz4_detail::ThreadPool> pool;
+        std::deque<std::future<std::string>> pending;
+        std::string current;
+        size_t offset = 0;
+        bool eof = false;
+        explicit State(std::shared_ptr<lz4_detail::ThreadPool> pool): pool(std::move(pool)) {}
+    };
+    size_t nb_threads;
+    /// null for a pool of nb_threads of its own
+    std::shared_ptr<lz4_detail::ThreadPool> shared_pool;
+    std::unique_ptr<State> state;
+
+    template<typename Source>
+    void read_chunk(Source& src) {
+        char header[lz4_detail::chunk_header_size];
+        const auto header_size = lz4_detail::read_all(src, header, sizeof(header));
+        if (header_size == 0) {
+            state->eof = true;
+            return;
+        }
+        if (header_size != std::streamsize(sizeof(header))) {
+            throw navitia::exception("truncated lz4 chunk header");
+        }
+        const uint32_t raw_size = lz4_detail::read_le32(header);
+        const uint32_t compressed_size = lz4_detail::read_le32(header + sizeof(uint32_t));
+        if (raw_size > lz4_detail::max_chunk_size || compressed_size > uint32_t(LZ4_compressBound(raw_size))) {
+            throw navitia::exception("corrupted lz4 chunk header");
+        }
+        std::string compressed(compressed_size, '\0');
+        if (lz4_detail::read_all(src, &compressed[0], compressed.size()) != std::streamsize(compressed.size())) {
+            throw navitia::exception("truncated lz4 chunk");
+        }
+        const auto compressed_ptr = std::make_shared<std::string>(std::move(compressed));
+        state->pending.push_back(state->pool->submit([raw_size, compressed_ptr]() {
+            std::string raw(raw_size, '\0');
+            const int size = LZ4_uncompress_unknownOutputSize(compressed_ptr->data(), &raw[0],
+                                                              compressed_ptr->size(), raw_size);
+            if (size != int(raw_size)) { throw LZ4Exception(); }
+            return raw;
+        }));
+    }
+
+public:
+    /**
+     * @param nb_threads nombre de threads de décompression
+     */
+    LZ4ParallelDecompressor(size_t nb_threads = lz4_detail::default_nb_threads()):
+        nb_threads(nb_threads) {}
+
+    /**
+     * @param pool threads partagés par plusieurs décompressions simultanées
+     */
+    explicit LZ4ParallelDecompressor(std::shared_ptr<lz4_detail::ThreadPool> pool):
+        nb_threads(pool->size()), shared_pool(std::move(pool)) {}
+
+    LZ4ParallelDecompressor(const LZ4ParallelDecompressor& other):
+        nb_threads(other.nb_threads), shared_pool(other.shared_pool) {}
+
+    template<typename Source>
+    std::streamsize read(Source& src, char* dest, std::streamsize size) {
+        if (! state) {
+            state.reset(new State(shared_pool ? shared_pool
+                                              : std::make_shared<lz4_detail::ThreadPool>(nb_threads)));
+        }
+        while (state->offset == state->current.size()) {
+            // keep the pool busy with the next chunks
+            while (! state->eof && state->pending.size() < 2 * nb_threads) { read_chunk(src); }
+            if (state->pending.empty()) { return -1; }
+            state->current = state->pending.front().get();
+            state->pending.pop_front();
+            state->offset = 0;
+        }
+        const std::streamsize nb = std::min<std::streamsize>(size, state->current.size() - state->offset);
+        memcpy(dest, state->current.data() + state->offset, nb);
+        state->offset += nb;
+        return nb;
+    }
+
+    template<typename Source>
+    void close(Source&) {
+        state.reset();
+    }
+};
@@ -98,3 +98,114 @@ BOOST_AUTO_TEST_CASE(big_string_compression){
     }
     BOOST_CHECK_EQUAL(str, result);
 }
+
+BOOST_AUTO_TEST_CASE(parallel_compression){
+    std::string str = "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf";
+    for (int i = 0; i < 14; i++) {
+        str += str + std::to_string(i);
+    }
+    for (bool high_compression: {false, true}) {
+        std::string result;
+        {
+            boost::iostreams::filtering_ostream out;
+            // small chunks to have a lot of them in flight
+            out.push(LZ4ParallelCompressor(4096, high_compression, 3));
+            out.push(boost::iostreams::file_sink("my_file.lz4"));
+            out << str;
+        }
+        {
+            boost::iostreams::filtering_istream in;
+            in.push(LZ4ParallelDecompressor(3));
+            in.push(boost::iostreams::file_source("my_file.lz4"));
+            in >> result;
+        }
+        BOOST_CHECK_EQUAL(str, result);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_shared_pool){
+    std::string str = "foobariozafiozehfuiozefuigaezgfuzegfpuzheuerfhzeupgf";
+    for (int i = 0; i < 12; i++) {
+        str += str + std::to_string(i);
+    }
+    {
+        boost::iostreams::filtering_ostream out;
+        out.push(LZ4ParallelCompressor(4096, false, 2));
+        out.push(boost::iostreams::file_sink("my_file.lz4"));
+        out << str;
+    }
+    // two streams decompressed at the same time by the same threads
+    const auto pool = std::make_shared<lz4_detail::ThreadPool>(2);
+    std::string results[2];
+    std::thread other([&]() {
+        boost::iostreams::filtering_istream in;
+        in.push(LZ4ParallelDecompressor(pool));
+        in.push(boost::iostreams::file_source("my_file.lz4"));
+        in >> results[1];
+    });
+    {
+        boost::iostreams::filtering_istream in;
+        in.push(LZ4ParallelDecompressor(pool));
+        in.push(boost::iostreams::file_source("my_file.lz4"));
+        in >> results[0];
+    }
+    other.join();
+    BOOST_CHECK_EQUAL(str, results[0]);
+    BOOST_CHECK_EQUAL(str, results[1]);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_empty_stream){
+    std::string result;
+    {
+        boost::iostreams::filtering_ostream out;
+        out.push(LZ4ParallelCompressor());
+        out.push(boost::iostreams::file_sink("my_file.lz4"));
+    }
+    {
+        boost::iostreams::filtering_istream in;
+        in.push(LZ4ParallelDecompressor());
+        in.push(boost::iostreams::file_source("my_file.lz4"));
+        in >> result;
+        BOOST_CHECK(in.eof());
+    }
+    BOOST_CHECK(result.empty());
+}
+
+BOOST_AUTO_TEST_CASE(parallel_truncated_stream){
+    std::string str(100000, 'a');
+    {
+        boost::iostreams::filtering_ostream out;
+        out.push(LZ4ParallelCompressor(1024, false, 2));
+        out.push(boost::iostreams::file_sink("my_file.lz4"));
+        out << str;
+    }
+    {
+        std::ifstream ifs("my_file.lz4", std::ios::binary);
+        std::string content((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        std::ofstream ofs("my_file.lz4", std::ios::binary);
+        ofs << content.substr(0, content.size() - 3);
+    }
+    std::string result;
+    boost::iostreams::filtering_istream in;
+    in.push(LZ4ParallelDecompressor(2));
+    in.push(boost::iostreams::file_source("my_file.lz4"));
+    in.exceptions(std::ios::badbit);
+    BOOST_CHECK_THROW(in >> result, std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(parallel_corrupted_chunk_size){
+    // a chunk of 1000 bytes claiming 4GB of compressed data
+    std::string header(8, '\0');
+    lz4_detail::write_le32(&header[0], 1000);
+    lz4_detail::write_le32(&header[4], 0xFFFFFFFF);
+    {
+        std::ofstream ofs("my_file.lz4", std::ios::binary);
+        ofs << header << "abc";
+    }
+    std::string result;
+    boost::iostreams::filtering_istream in;
+    in.push(LZ4ParallelDecompressor(2));
+    in.push(boost::iostreams::file_source("my_file.lz4"));
+    in.exceptions(std::ios::badbit);
+    BOOST_CHECK_THROW(in >> result, std::exception);
+}
@@ -244,7 +244,7 @@ int main(int argc, char** argv){
     std::vector<Result> results;
     data.build_raptor();
     RAPTOR router(data);
-    auto georef_worker = georef::StreetNetwork(*data.geo_ref);
+    auto georef_worker = georef::StreetNetwork(*data.geo_ref, *data.projected_stop_points);
 
     std::cout << "On lance le benchmark de l'algo " << std::endl;
     boost::progress_display show_progress(demands.size());
@@ -31,22 +31,104 @@ www.navitia.io
 #include "dataraptor.h"
 #include "routing.h"
 #include "routing/raptor_utils.h"
+#include "utils/logger.h"
 
 #include <boost/range/algorithm_ext.hpp>
+#include <queue>
 
 namespace navitia { namespace routing {
 
+using Connection = dataRAPTOR::Connections::Connection;
+
+static dataRAPTOR::Connections::Csr make_csr(const std::vector<std::vector<Connection>>& rows) {
+    dataRAPTOR::Connections::Csr csr;
+    csr.offsets.reserve(rows.size() + 1);
+    csr.offsets.push_back(0);
+    for (const auto& row: rows) {
+        csr.offsets.push_back(csr.offsets.back() + row.size());
+    }
+    csr.connections.reserve(csr.offsets.back());
+    for (const auto& row: rows) {
+        boost::push_back(csr.connections, row);
+    }
+    return csr;
+}
+
+// bounded dijkstra from every stop point over the connections
+static std::vector<std::vector<Connection>>
+close_transfers(const std::vector<std::vector<Connection>>& direct, const DateTime max_duration) {
+    std::vector<std::vector<Connection>> closed(direct.size());
+    std::vector<DateTime> durations(direct.size(), DateTimeUtils::inf);
+    std::vector<DateTime> display_durations(direct.size(), 0);
+    std::vector<size_t> reached;
+    using Item = std::pair<DateTime, size_t>;
+    for (size_t from = 0; from < direct.size(); ++from) {
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+        durations[from] = 0;
+        reached.push_back(from);
+        queue.push({0, from});
+        while (! queue.empty()) {
+            const auto item = queue.top();
+            queue.pop();
+            if (item.first > durations[item.second]) { continue; }
+            for (const auto& conn: direct[item.second]) {
+                const DateTime duration = item.first + conn.duration;
+                if (duration > max_duration || duration >= durations[conn.sp_idx.val]) { continue; }
+                if (durations[conn.sp_idx.val] == DateTimeUtils::inf) { reached.push_back(conn.sp_idx.val); }
+                durations[conn.sp_idx.val] = duration;
+                display_durations[conn.sp_idx.val] = display_durations[item.second] + conn.display_duration;
+                queue.push({duration, conn.sp_idx.val});
+            }
+        }
+        // the direct connections, shortened by a shorter chain if any
+        auto& row = closed[from];
+        row = direct[from];
+        for (auto& conn: row) {
+            auto& duration = durations[conn.sp_idx.val];
+            if (conn.sp_idx.val == from || duration == DateTimeUtils::inf) { continue; }
+            if (duration < conn.duration) {
+                conn.duration = duration;
+                conn.display_duration = display_durations[conn.sp_idx.val];
+            }
+            duration = DateTimeUtils::inf;
+        }
+        // then the chains between stop points without connection
+        for (const auto to: reached) {
+            if (to != from && durations[to] != DateTimeUtils::inf) {
+                row.push_back({durations[to], display_durations[to], SpIdx(to)});
+            }
+            durations[to] = DateTimeUtils::inf;
+        }
+        reached.clear();
+    }
+    return closed;
+}
+
+const Connection* dataRAPTOR::Connections::Csr::find(const SpIdx& sp, const SpIdx& destination) const {
+    for (const auto& conn: (*this)[sp]) {
+        if (conn.sp_idx == destination) { return &conn; }
+    }
+    return nullptr;
+}
+
 void dataRAPTOR::Connections::load(const type::PT_Data& data) {
-    forward_connections.assign(data.stop_points);
-    backward_connections.assign(data.stop_points);
+    std::vector<std::vector<Connection>> forward(data.stop_points.size());
     for (const auto* conn: data.stop_point_connections) {
-        forward_connections[SpIdx(*conn->departure)].push_back(
-            {DateTime(conn->duration), SpIdx(*conn->destination)});
-        backward_connections[SpIdx(*conn->destination)].push_back(
-            {DateTime(conn->duration), SpIdx(*conn->departure)});
+        forward[conn->departure->idx].push_back(
+            {DateTime(conn->duration), DateTime(conn->display_duration), SpIdx(*conn->destination)});
+    }
+    if (closure_duration > 0) {
+        forward = close_transfers(forward, closure_duration);
     }
-    for (auto& conns: forward_connections.values()) { conns.shrink_to_fit(); }
-    for (auto& conns: backward_connections.values()) { conns.shrink_to_fit(); }
+    std::vector<std::vector<Connection>> backward(data.stop_points.size());
+    for (size_t sp = 0; sp < forward.size(); ++sp) {
+        for (const auto& conn: forward[sp]) {
+            backward[conn.sp_idx.val].push_back({conn.duration, conn.display_duration, SpIdx(sp)});
+        }
+    }
+    forward_connections = make_csr(forward);
+    backward_connections = make_csr(backward);
+    nb_stop_point_connections = data.stop_point_connections.size();
 }
 
 void dataRAPTOR::JppsFromSp::load(const type::PT_Data& data,
@@ -69,6 +151,22 @@ void dataRAPTOR::JppsFromSp::filter_jpps(const boost::dynamic_bitset<>& valid_jp
     }
 }
 
+size_t dataRAPTOR::JppsFromSp::memory_usage() const {
+    size_t res = 0;
+    for (const auto& jpps: jpps_from_sp) {
+        res += sizeof(jpps.second) + jpps.second.capacity() * sizeof(Jpp);
+    }
+    return res;
+}
+
+size_t dataRAPTOR::JppsFromJp::memory_usage() const {
+    size_t res = 0;
+    for (const auto& jpps: jpps_from_jp) {
+        res += sizeof(jpps.second) + jpps.second.capacity() * sizeof(Jpp);
+    }
+    return res;
+}
+
 void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
     jpps_from_jp.assign(jp_container.get_jps_values());
     for (const auto& jp: jp_container.get_jps()) {
@@ -85,19 +183,106 @@ void dataRAPTOR::JppsFromJp::load(const JourneyPatternContainer& jp_container) {
 void dataRAPTOR::load(const type::PT_Data& data, size_t cache_size)
 {
     jp_container.load(data);
+    load_from_jp_container(data, nullptr, std::vector<boost::optional<JpIdx>>(jp_container.nb_jps()),
+                           cache_size);
+}
+
+static type::idx_t vp_idx(const type::ValidityPattern* vp) {
+    return vp ? vp->idx : type::invalid_idx;
+}
+
+// A route is dirty if its vjs are not exactly the ones previous has
+// been built with.  Realtime never removes a vj from pt_data: it
+// appends new vjs to the routes and changes the validity patterns of
+// the others, thus comparing the idx is enough.
+static boost::dynamic_bitset<>
+make_dirty_routes(const type::PT_Data& data, const JourneyPatternContainer& previous) {
+    boost::dynamic_bitset<> dirty_routes(data.routes.size());
+    for (const auto* route: data.routes) {
+        size_t nb_vjs = 0;
+        bool is_dirty = false;
+        for (const auto& jp_idx: previous.get_jps_from_route()[RouteIdx(*route)]) {
+            previous.get(jp_idx).for_each_vehicle_journey([&](const type::VehicleJourney& old_vj) {
+                ++nb_vjs;
+                const auto* vj = data.vehicle_journeys[old_vj.idx];
+                is_dirty = vj->route->idx != old_vj.route->idx
+                    || vj->physical_mode->idx != old_vj.physical_mode->idx
+                    || vj->stop_time_list.size() != old_vj.stop_time_list.size();
+                for (const auto level: {type::RTLevel::Base, type::RTLevel::Adapted, type::RTLevel::RealTime}) {
+                    is_dirty = is_dirty
+                        || vp_idx(vj->validity_patterns[level]) != vp_idx(old_vj.validity_patterns[level]);
+                }
+                return ! is_dirty;
+            });
+            if (is_dirty) { break; }
+        }
+        if (is_dirty || nb_vjs != route->discrete_vehicle_journey_list.size()
+                                  + route->frequency_vehicle_journey_list.size()) {
+            dirty_routes.set(route->idx);
+        }
+    }
+    return dirty_routes;
+}
+
+void dataRAPTOR::load(const type::PT_Data& data, const dataRAPTOR& previous, size_t cache_size)
+{
+    connections.closure_duration = previous.connections.closure_duration;
+    const auto& previous_jps_from_route = previous.jp_container.get_jps_from_route().values();
+    const auto& previous_jp_from_vj = previous.jp_container.get_jp_from_vj().values();
+    if (previous_jps_from_route.size() != data.routes.size()
+            || previous_jp_from_vj.size() > data.vehicle_journeys.size()) {
+        // not a newer generation of the same data
+        return load(data, cache_size);
+    }
+    const auto dirty_routes = make_dirty_routes(data, previous.jp_container);
+    // copying is only interesting when most of the routes are kept
+    if (dirty_routes.count() * 2 > dirty_routes.size()) {
+        return load(data, cache_size);
+    }
+    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("log"),
+                    "Incremental dataRaptor build, " << dirty_routes.count() << " routes on "
+                    << dirty_routes.size() << " to compute");
+    const auto copied_from = jp_container.load(data, previous.jp_container, dirty_routes);
+    load_from_jp_container(data, &previous, copied_from, cache_size);
+}
+
+void dataRAPTOR::load_from_jp_container(const type::PT_Data& data,
+                                        const dataRAPTOR* previous,
+                                        const std::vector<boost::optional<JpIdx>>& copied_from,
+                                        size_t cache_size)
+{
     labels_const.init_inf(data.stop_points);
     labels_const_reverse.init_min(data.stop_points);
 
-    connections.load(data);
+    // realtime doesn't change the connections, and the closure is costly
+    if (previous && previous->connections.closure_duration == connections.closure_duration
+            && previous->connections.forward_connections.nb_stop_points() == data.stop_points.size()
+            && previous->connections.nb_stop_point_connections == data.stop_point_connections.size()) {
+        connections = previous->connections;
+    } else {
+        connections.load(data);
+    }
     jpps_from_sp.load(data, jp_container);
     jpps_from_jp.load(jp_container);
-    next_stop_time_data.load(jp_container);
+    if (previous) {
+        next_stop_time_data.load(jp_container, data, previous->next_stop_time_data,
+                                 previous->jp_container, copied_from);
+    } else {
+        next_stop_time_data.load(jp_container);
+    }
 
     for (auto level_cont: jp_validity_patterns) {
         const auto rt_level = level_cont.first;
         auto& jp_vp = level_cont.second;
         jp_vp.assign(366, boost::dynamic_bitset<>(jp_container.nb_jps()));
         for (const auto& jp: jp_container.get_jps()) {
+            if (const auto& old_jp_idx = copied_from[jp.first.val]) {
+                const auto& old_jp_vp = previous->jp_validity_patterns[rt_level];
+                for (int i = 0; i <= 365; ++i) {
+                    jp_vp[i][jp.first.val] = old_jp_vp[i][old_jp_idx->val];
+                }
+                continue;
+            }
             for (int i = 0; i <= 365; ++i) {
                 jp.second.for_each_vehicle_journey([&](const nt::VehicleJourney& vj) {
                     if (vj.validity_patterns[rt_level]->check2(i)) {
@@ -111,10 +296,8 @@ void dataRAPTOR::load(const type::PT_Data& data, size_t cache_size)
     }
 
     min_connection_time = std::numeric_limits<uint32_t>::max();
-    for (const auto& conns : connections.forward_connections) {
-        for (const auto& conn : conns.second) {
-            min_connection_time = std::min(min_connection_time, conn.duration);
-        }
+    for (const auto& conn : connections.forward_connections.connections) {
+        min_connection_time = std::min(min_connection_time, conn.duration);
     }
 
     cached_next_st_manager = std::make_unique<CachedNextStopTimeManager>(*this, cache_size);
@@ -38,6 +38,7 @@ www.navitia.io
 
 #include <boost/foreach.hpp>
 #include <boost/dynamic_bitset.hpp>
+#include <boost/range/iterator_range.hpp>
 
 namespace navitia { namespace routing {
 
@@ -48,14 +49,41 @@ struct dataRAPTOR {
     struct Connections {
         struct Connection {
             DateTime duration;
+            DateTime display_duration;
             SpIdx sp_idx;
         };
+        // compressed sparse rows: the connections of a stop point sp are
+        // connections[offsets[sp], offsets[sp + 1]), all of them in a
+        // single contiguous array
+        struct Csr {
+            using const_iterator = std::vector<Connection>::const_iterator;
+            std::vector<uint32_t> offsets;
+            std::vector<Connection> connections;
+
+            inline boost::iterator_range<const_iterator> operator[](const SpIdx& sp) const {
+                return boost::make_iterator_range(connections.begin() + offsets[sp.val],
+                                                  connections.begin() + offsets[sp.val + 1]);
+            }
+            inline size_t nb_stop_points() const {
+                return offsets.empty() ? 0 : offsets.size() - 1;
+            }
+            /// the connection from sp to destination, nullptr if there is none
+            const Connection* find(const SpIdx& sp, const SpIdx& destination) const;
+        };
         void load(const navitia::type::PT_Data&);
 
+        // The transfers chaining several connections in less than
+        // closure_duration seconds are added, with the duration of the
+        // shortest chain, so that RAPTOR needs only one transfer by
+        // round. 0 disables it.
+        DateTime closure_duration = 0;
+        // the stop point connections of pt_data the connections are built from
+        size_t nb_stop_point_connections = 0;
+
         // for a stop point, get the corresponding forward connections
-        IdxMap<type::StopPoint, std::vector<Connection>> forward_connections;
+        Csr forward_connections;
         // for a stop point, get the corresponding backward connections
-        IdxMap<type::StopPoint, std::vector<Connection>> backward_connections;
+        Csr backward_connections;
     };
     Connections connections;
     DateTime min_connection_time;
@@ -73,6 +101,7 @@ struct dataRAPTOR {
         }
         void load(const type::PT_Data&, const JourneyPatternContainer&);
         void filter_jpps(const boost::dynamic_bitset<>& valid_jpps);
+        size_t memory_usage() const;
 
         inline IdxMap<type::StopPoint, std::vector<Jpp>>::const_iterator
         begin() const { return jpps_from_sp.begin(); }
@@ -95,6 +124,7 @@ struct dataRAPTOR {
             return jpps_from_jp[jp];
         }
         void load(const JourneyPatternContainer&);
+        size_t memory_usage() const;
     private:
         IdxMap<JourneyPattern, std::vector<Jpp>> jpps_from_jp;
     };
@@ -114,6 +144,23 @@ struct dataRAPTOR {
 
     dataRAPTOR() {}
     void load(const navitia::type::PT_Data&, size_t cache_size = 10);
+    // Loads pt_data, a newer generation of the pt_data previous has
+    // been loaded from (typically a clone with realtime applied):
+    // only the routes whose vjs changed are computed again, the
+    // others are copied from previous, that must stay alive during
+    // the call.  Falls back to a full load if too many routes changed.
+    void load(const navitia::type::PT_Data&, const dataRAPTOR& previous, size_t cache_size = 10);
+
+    /// the duration and display duration of a transfer, from the connections of RAPTOR
+    const Connections::Connection* get_connection(const type::StopPoint& from, const type::StopPoint& to) const {
+        return connections.forward_connections.find(SpIdx(from), SpIdx(to));
+    }
+
+private:
+    void load_from_jp_container(const navitia::type::PT_Data&,
+                                const dataRAPTOR* previous,
+                                const std::vector<boost::optional<JpIdx>>& copied_from,
+                                size_t cache_size);
 };
 
 }}
@@ -241,9 +241,10 @@ static double walking_distance(const DateTime& max_duration,
 }
 
 std::vector<navitia::time_duration> init_distance(const georef::GeoRef & worker,
+                                                  const georef::ProjectedStopPoints& projected_stop_points,
                                                   const std::vector<type::StopPoint*>& stop_points,
                                                   const DateTime& init_dt,
-                                                  const RAPTOR& raptor,
+                                                  const IdxMap<type::StopPoint, DateTime>& best_labels,
                                                   const type::Mode_e& mode,
                                                   const type::GeographicalCoord& coord_origin,
                                                   const bool clockwise,
@@ -261,9 +262,9 @@ std::vector<navitia::time_duration> init_distance(const georef::GeoRef & worker,
     }
     for(const type::StopPoint* sp: stop_points) {
         SpIdx sp_idx(*sp);
-        const auto& best_lbl = raptor.best_labels_pts[sp_idx];
+        const auto& best_lbl = best_labels[sp_idx];
         if (in_bound(best_lbl, bound, clockwise)) {
-            const auto& projections = worker.projected_stop_points[sp->idx];
+            const auto& projections = projected_stop_points[sp->idx];
             const auto& proj = projections[mode];
             if(proj.found) {
                 const double duration = best_lbl - init_dt;
@@ -276,8 +277,9 @@ std::vector<navitia::time_duration> init_distance(const georef::GeoRef & worker,
 }
 
 static std::vector<georef::vertex_t> init_vertex(const georef::GeoRef & worker,
+                                                 const georef::ProjectedStopPoints& projected_stop_points,
                                                  const std::vector<type::StopPoint*>& stop_points,
-                                                 const RAPTOR& raptor,
+                                                 const IdxMap<type::StopPoint, DateTime>& best_labels,
                                                  const type::Mode_e& mode,
                                                  const type::GeographicalCoord& coord_origin,
                                                  const bool clockwise,
@@ -291,9 +293,9 @@ static std::vector<georef::vertex_t> init_vertex(const georef::GeoRef & worker,
     }
     for(const type::StopPoint* sp: stop_points) {
         SpIdx sp_idx(*sp);
-        const auto& best_lbl = raptor.best_labels_pts[sp_idx];
+        const auto& best_lbl = best_labels[sp_idx];
         if (in_bound(best_lbl, bound, clockwise)) {
-            const auto& projections = worker.projected_stop_points[sp->idx];
+            const auto& projections = projected_stop_points[sp->idx];
             const auto& proj = projections[mode];
             if(proj.found) {
                 initialized_points.push_back(proj[source_e]);
@@ -305,9 +307,10 @@ static std::vector<georef::vertex_t> init_vertex(const georef::GeoRef & worker,
 }
 
 static BoundBox find_boundary_box(const georef::GeoRef & worker,
+                                  const georef::ProjectedStopPoints& projected_stop_points,
                                   const std::vector<type::StopPoint*>& stop_points,
                                   const DateTime& init_dt,
-                                  const RAPTOR& raptor,
+                                  const IdxMap<type::StopPoint, DateTime>& best_labels,
                                   const type::Mode_e& mode,
                                   const type::GeographicalCoord& coord_origin,
                                   const bool clockwise,
@@ -323,9 +326,9 @@ static BoundBox find_boundary_box(const georef::GeoRef & worker,
     }
     for(const type::StopPoint* sp: stop_points) {
         SpIdx sp_idx(*sp);
-        const auto& best_lbl = raptor.best_labels_pts[sp_idx];
+        const auto& best_lbl = best_labels[sp_idx];
         if (in_bound(best_lbl, bound, clockwise)) {
-            const auto& projections = worker.projected_stop_points[sp->idx];
+            const auto& projections = projected_stop_points[sp->idx];
             const auto& proj = projections[mode];
             if(proj.found) {
                 const double duration = best_lbl - init_dt;
@@ -337,7 +340,23 @@ static BoundBox find_boundary_box(const georef::GeoRef & worker,
 }
 
 
+std::vector<navitia::time_duration> init_distance(const georef::GeoRef & worker,
+                                                  const georef::ProjectedStopPoints& projected_stop_points,
+                                                  const std::vector<type::StopPoint*>& stop_points,
+                                                  const DateTime& init_dt,
+                                                  const RAPTOR& raptor,
+                                                  const type::Mode_e& mode,
+                                                  const type::GeographicalCoord& coord_origin,
+                                                  const bool clockwise,
+                                                  const DateTime& bound,
+                                                  const double speed,
+                                                  const DateTime& duration) {
+    return init_distance(worker, projected_stop_points, stop_points, init_dt, raptor.best_labels_pts,
+                         mode, coord_origin, clockwise, bound, speed, duration);
+}
+
 std::string build_raster_isochrone(const georef::GeoRef& worker,
+                                   const georef::ProjectedStopPoints& projected_stop_points,
                                    const double& speed,
                                    const type::Mode_e& mode,
                                    const DateTime init_dt,
@@ -347,16 +366,32 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
                                    const bool clockwise,
                                    const DateTime bound,
                                    const uint resolution) {
-    const auto& stop_points = raptor.data.pt_data->stop_points;
+    return build_raster_isochrone(worker, projected_stop_points, speed, mode, init_dt,
+                                  raptor.data.pt_data->stop_points, raptor.best_labels_pts, coord_origin,
+                                  duration, clockwise, bound, resolution);
+}
+
+std::string build_raster_isochrone(const georef::GeoRef& worker,
+                                   const georef::ProjectedStopPoints& projected_stop_points,
+                                   const double& speed,
+                                   const type::Mode_e& mode,
+                                   const DateTime init_dt,
+                                   const std::vector<type::StopPoint*>& stop_points,
+                                   const IdxMap<type::StopPoint, DateTime>& best_labels,
+                                   const type::GeographicalCoord& coord_origin,
+                                   const DateTime duration,
+                                   const bool clockwise,
+                                   const DateTime bound,
+                                   const uint resolution) {
     std::vector<georef::vertex_t> predecessors;
     size_t n = boost::num_vertices(worker.graph);
     predecessors.resize(n);
-    auto box = find_boundary_box(worker, stop_points, init_dt, raptor, mode, coord_origin,
-                                 clockwise, bound, duration, speed);
-    auto init_points = init_vertex(worker, stop_points, raptor, mode, coord_origin,
-                                   clockwise, bound);
-    auto distances = init_distance(worker, stop_points, init_dt, raptor, mode, coord_origin,
-                                   clockwise, bound, speed, duration);
+    auto box = find_boundary_box(worker, projected_stop_points, stop_points, init_dt, best_labels, mode,
+                                 coord_origin, clockwise, bound, duration, speed);
+    auto init_points = init_vertex(worker, projected_stop_points, stop_points, best_labels, mode,
+                                   coord_origin, clockwise, bound);
+    auto distances = init_distance(worker, projected_stop_points, stop_points, init_dt, best_labels, mode,
+                                   coord_origin, clockwise, bound, speed, duration);
     auto start = init_points.begin();
     auto end = init_points.end();
     double speed_factor = speed / georef::default_speed[mode];
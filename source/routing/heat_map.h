@@ -101,6 +101,7 @@ constexpr static double N_DEG_TO_DISTANCE = type::GeographicalCoord::N_DEG_TO_RA
 
 
 std::vector<navitia::time_duration> init_distance(const georef::GeoRef & worker,
+                                                  const georef::ProjectedStopPoints& projected_stop_points,
                                                   const std::vector<type::StopPoint*>& stop_points,
                                                   const DateTime& init_dt,
                                                   const RAPTOR& raptor,
@@ -111,6 +112,18 @@ std::vector<navitia::time_duration> init_distance(const georef::GeoRef & worker,
                                                   const double speed,
                                                   const DateTime& duration);
 
+std::vector<navitia::time_duration> init_distance(const georef::GeoRef & worker,
+                                                  const georef::ProjectedStopPoints& projected_stop_points,
+                                                  const std::vector<type::StopPoint*>& stop_points,
+                                                  const DateTime& init_dt,
+                                                  const IdxMap<type::StopPoint, DateTime>& best_labels,
+                                                  const type::Mode_e& mode,
+                                                  const type::GeographicalCoord& coord_origin,
+                                                  const bool clockwise,
+                                                  const DateTime& bound,
+                                                  const double speed,
+                                                  const DateTime& duration);
+
 HeatMap fill_heat_map(const BoundBox& box,
                       const double height_step,
                       const double width_step,
@@ -124,6 +137,7 @@ HeatMap fill_heat_map(const BoundBox& box,
 std::string print_grid(const HeatMap& heat_map);
 
 std::string build_raster_isochrone(const georef::GeoRef& worker,
+                                   const georef::ProjectedStopPoints& projected_stop_points,
                                    const double& speed,
                                    const type::Mode_e& mode,
                                    const DateTime init_dt,
@@ -134,4 +148,19 @@ std::string build_raster_isochrone(const georef::GeoRef& worker,
                                    const DateTime bound,
                                    const uint resolution);
 
+// Same as above, with the stop points reached at best_labels, for
+// example the labels of an IsochroneProfile
+std::string build_raster_isochrone(const georef::GeoRef& worker,
+                                   const georef::ProjectedStopPoints& projected_stop_points,
+                                   const double& speed,
+                                   const type::Mode_e& mode,
+                                   const DateTime init_dt,
+                                   const std::vector<type::StopPoint*>& stop_points,
+                                   const IdxMap<type::StopPoint, DateTime>& best_labels,
+                                   const type::GeographicalCoord& coord_origin,
+                                   const DateTime duration,
+                                   const bool clockwise,
+                                   const DateTime bound,
+                                   const uint resolution);
+
 }} //namespace navitia::routing
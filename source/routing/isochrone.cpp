@@ -44,6 +44,10 @@ www.navitia.io
 #include <string>
 #include <algorithm>
 #include <boost/range/algorithm.hpp>
+#include <atomic>
+#include <thread>
+#include <exception>
+#include <limits>
 
 namespace navitia { namespace routing {
 
@@ -199,10 +203,23 @@ type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
                                           const map_stop_point_duration& origin,
                                           const double& speed,
                                           const int& duration) {
+    return build_single_isochrone(raptor.data, raptor.best_labels_pts, stop_points, clockwise,
+                                  coord_origin, bound, origin, speed, duration);
+}
+
+type::MultiPolygon build_single_isochrone(const type::Data& data,
+                                          const IdxMap<type::StopPoint, DateTime>& best_labels,
+                                          const std::vector<type::StopPoint*>& stop_points,
+                                          const bool clockwise,
+                                          const type::GeographicalCoord& coord_origin,
+                                          const DateTime& bound,
+                                          const map_stop_point_duration& origin,
+                                          const double& speed,
+                                          const int& duration) {
     std::vector<InfoCircle> circles_classed;
     type::MultiPolygon circles;
     circles_classed.push_back(InfoCircle(coord_origin, duration));
-    const auto& data_departure = raptor.data.pt_data->stop_points;
+    const auto& data_departure = data.pt_data->stop_points;
     for (auto it = origin.begin(); it != origin.end(); ++it){
         if (it->second.total_seconds() < duration) {
             int duration_left = duration - int(it->second.total_seconds());
@@ -213,7 +230,7 @@ type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
     }
     for(const type::StopPoint* sp: stop_points) {
         SpIdx sp_idx(*sp);
-        const auto best_lbl = raptor.best_labels_pts[sp_idx];
+        const auto best_lbl = best_labels[sp_idx];
         if (in_bound(best_lbl, bound, clockwise)) {
             uint duration_left = abs(int(best_lbl) - int(bound));
             if (duration_left * speed < MIN_RADIUS) {continue;}
@@ -237,16 +254,28 @@ std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
                            const double& speed,
                            const std::vector<DateTime>& boundary_duration,
                            const DateTime init_dt) {
+    return build_isochrones(raptor.data, raptor.best_labels_pts, clockwise, coord_origin, origin,
+                            speed, boundary_duration, init_dt);
+}
+
+std::vector<Isochrone> build_isochrones(const type::Data& data,
+                           const IdxMap<type::StopPoint, DateTime>& best_labels,
+                           const bool clockwise,
+                           const type::GeographicalCoord& coord_origin,
+                           const map_stop_point_duration& origin,
+                           const double& speed,
+                           const std::vector<DateTime>& boundary_duration,
+                           const DateTime init_dt) {
     std::vector<Isochrone> isochrone;
     if (!boundary_duration.empty()) {
-        type::MultiPolygon max_isochrone = build_single_isochrone(raptor, raptor.data.pt_data->stop_points,
+        type::MultiPolygon max_isochrone = build_single_isochrone(data, best_labels, data.pt_data->stop_points,
                                                                   clockwise, coord_origin,
                                                                   build_bound(clockwise, boundary_duration[0], init_dt),
                                                                   origin, speed, boundary_duration[0]);
         for (size_t i = 1; i < boundary_duration.size(); i++) {
             type::MultiPolygon output;
             if (boundary_duration[i] > 0) {
-                type::MultiPolygon min_isochrone = build_single_isochrone(raptor, raptor.data.pt_data->stop_points,
+                type::MultiPolygon min_isochrone = build_single_isochrone(data, best_labels, data.pt_data->stop_points,
                                                                           clockwise, coord_origin,
                                                                           build_bound(clockwise, boundary_duration[i], init_dt),
                                                                           origin, speed, boundary_duration[i]);
@@ -262,4 +291,175 @@ std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
     return isochrone;
 }
 
+static IsochroneTravelTimes make_travel_times(const RAPTOR& raptor,
+                                              const map_stop_point_duration& departures,
+                                              const bool clockwise,
+                                              const DateTime init_dt,
+                                              const DateTime bound) {
+    IsochroneTravelTimes res;
+    const auto max_duration = uint32_t(abs(int(bound) - int(init_dt)));
+    auto dep_it = departures.begin();
+    for (const auto& sp_lbl: raptor.best_labels_pts) {
+        uint32_t duration = std::numeric_limits<uint32_t>::max();
+        if (in_bound(sp_lbl.second, bound, clockwise)) {
+            duration = abs(int(sp_lbl.second) - int(init_dt));
+        }
+        // departures is sorted by stop point, as best_labels_pts
+        for (; dep_it != departures.end() && dep_it->first < sp_lbl.first; ++dep_it) {}
+        if (dep_it != departures.end() && dep_it->first == sp_lbl.first) {
+            duration = std::min(duration, uint32_t(dep_it->second.total_seconds()));
+        }
+        if (duration > max_duration) { continue; }
+        res.items.push_back({sp_lbl.first, duration});
+    }
+    return res;
+}
+
+std::vector<IsochroneTravelTimes>
+build_isochrone_batch(const type::Data& data,
+                      const std::vector<type::EntryPoint>& origins,
+                      const DateTime init_dt,
+                      const DateTime bound,
+                      uint32_t max_transfers,
+                      const type::AccessibiliteParams& accessibilite_params,
+                      const std::vector<std::string>& forbidden,
+                      const bool clockwise,
+                      const nt::RTLevel rt_level,
+                      size_t nb_threads) {
+    std::vector<IsochroneTravelTimes> res(origins.size());
+    if (origins.empty()) { return res; }
+    nb_threads = std::max(size_t(1), std::min(nb_threads, origins.size()));
+
+    // the date dependent data are computed once for every origin
+    RAPTOR shared_raptor(data);
+    shared_raptor.init_isochrone(init_dt, bound, accessibilite_params, forbidden, clockwise, rt_level);
+
+    std::atomic<size_t> next_origin(0);
+    std::vector<std::exception_ptr> errors(nb_threads);
+    auto work = [&](const size_t thread_idx) {
+        try {
+            RAPTOR raptor(data);
+            raptor.share_isochrone_init(shared_raptor);
+            georef::StreetNetwork worker(*data.geo_ref, *data.projected_stop_points);
+            for (size_t i = next_origin++; i < origins.size(); i = next_origin++) {
+                worker.init(origins[i]);
+                const auto departures = get_stop_points(origins[i], data, worker);
+                if (departures.empty()) { continue; }
+                raptor.run_isochrone(departures, init_dt, bound, max_transfers,
+                                     accessibilite_params, clockwise, rt_level);
+                res[i] = make_travel_times(raptor, departures, clockwise, init_dt, bound);
+            }
+        } catch (...) {
+            errors[thread_idx] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (size_t thread_idx = 1; thread_idx < nb_threads; ++thread_idx) {
+        threads.emplace_back(work, thread_idx);
+    }
+    work(0);
+    for (auto& thread: threads) { thread.join(); }
+    for (const auto& error: errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+    return res;
+}
+
+uint32_t IsochroneProfile::StopStats::get(const Stat stat) const {
+    switch (stat) {
+    case Stat::Min: return min;
+    case Stat::Median: return median;
+    case Stat::Percentile: return percentile;
+    }
+    return min;
+}
+
+IdxMap<type::StopPoint, DateTime> IsochroneProfile::to_labels(const std::vector<type::StopPoint*>& stop_points,
+                                                              const Stat stat,
+                                                              const DateTime init_dt,
+                                                              const bool clockwise) const {
+    IdxMap<type::StopPoint, DateTime> labels(stop_points);
+    boost::fill(labels.values(), clockwise ? DateTimeUtils::inf : DateTimeUtils::min);
+    for (const auto& sp_stats: stats) {
+        const auto duration = sp_stats.second.get(stat);
+        if (duration == std::numeric_limits<uint32_t>::max()) { continue; }
+        if (clockwise) {
+            labels[sp_stats.first] = init_dt + duration;
+        } else if (duration <= init_dt) {
+            labels[sp_stats.first] = init_dt - duration;
+        }
+    }
+    return labels;
+}
+
+// k-th smallest duration, the missing samples being unreachable
+static uint32_t order_statistic(std::vector<uint32_t>& durations, const size_t nb_samples, const size_t k) {
+    if (k >= durations.size() || k >= nb_samples) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    std::nth_element(durations.begin(), durations.begin() + k, durations.end());
+    return durations[k];
+}
+
+IsochroneProfile build_isochrone_profile(RAPTOR& raptor,
+                                         const map_stop_point_duration& departures,
+                                         const DateTime window_begin,
+                                         const DateTime window_end,
+                                         const uint32_t step,
+                                         const uint32_t max_duration,
+                                         uint32_t max_transfers,
+                                         const type::AccessibiliteParams& accessibilite_params,
+                                         const std::vector<std::string>& forbidden,
+                                         const bool clockwise,
+                                         const nt::RTLevel rt_level,
+                                         const double percentile) {
+    if (window_begin > window_end || step == 0) {
+        throw IsochroneException("invalid departure window");
+    }
+    if (percentile <= 0 || percentile > 1) {
+        throw IsochroneException("invalid percentile");
+    }
+    const auto& stop_points = raptor.data.pt_data->stop_points;
+    IsochroneProfile profile(stop_points);
+
+    std::vector<DateTime> datetimes;
+    for (DateTime dt = window_begin; dt <= window_end; dt += step) {
+        datetimes.push_back(dt);
+    }
+    // for a range raptor, the later departures must be computed first
+    if (clockwise) { boost::reverse(datetimes); }
+    profile.nb_departures = datetimes.size();
+
+    const DateTime b = clockwise ? window_end + max_duration
+                                 : (window_begin > max_duration ? window_begin - max_duration : 0);
+    raptor.init_isochrone(clockwise ? window_begin : window_end, b, accessibilite_params,
+                          forbidden, clockwise, rt_level);
+    raptor.clear(clockwise, limit_bound(clockwise, datetimes.front(), b));
+
+    IdxMap<type::StopPoint, std::vector<uint32_t>> durations(stop_points);
+    for (const auto dt: datetimes) {
+        raptor.rerun_isochrone(departures, dt, max_transfers, accessibilite_params,
+                               clockwise, rt_level);
+        const DateTime bound = build_bound(clockwise, max_duration, dt);
+        for (const auto& item: make_travel_times(raptor, departures, clockwise, dt, bound).items) {
+            durations[item.sp_idx].push_back(item.duration);
+        }
+    }
+
+    const size_t n = profile.nb_departures;
+    const size_t median_rank = (n - 1) / 2;
+    const size_t percentile_rank = size_t(std::ceil(percentile * n)) - 1;
+    for (const type::StopPoint* sp: stop_points) {
+        const SpIdx sp_idx(*sp);
+        auto& d = durations[sp_idx];
+        if (d.empty()) { continue; }
+        auto& sp_stats = profile.stats[sp_idx];
+        sp_stats.min = *boost::min_element(d);
+        sp_stats.median = order_statistic(d, n, median_rank);
+        sp_stats.percentile = order_statistic(d, n, percentile_rank);
+    }
+    return profile;
+}
+
 }} //namespace navitia::routing
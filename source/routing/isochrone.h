@@ -34,6 +34,7 @@ www.navitia.io
 #include "utils/exception.h"
 #include "raptor.h"
 #include <set>
+#include <limits>
 
 namespace navitia { namespace routing {
 
@@ -78,6 +79,17 @@ type::MultiPolygon build_single_isochrone(RAPTOR& raptor,
                                 const double& speed,
                                 const int& duration);
 
+// Same as above, with the stop points reached at best_labels
+type::MultiPolygon build_single_isochrone(const type::Data& data,
+                                const IdxMap<type::StopPoint, DateTime>& best_labels,
+                                const std::vector<type::StopPoint*>& stop_points,
+                                const bool clockwise,
+                                const type::GeographicalCoord& coord_origin,
+                                const DateTime& bound,
+                                const map_stop_point_duration &origine,
+                                const double& speed,
+                                const int& duration);
+
 struct Isochrone {
     type::MultiPolygon shape;
     DateTime min_duration;
@@ -99,4 +111,81 @@ std::vector<Isochrone> build_isochrones(RAPTOR& raptor,
                                         const std::vector<DateTime>& boundary_duration,
                                         const DateTime init_dt);
 
+std::vector<Isochrone> build_isochrones(const type::Data& data,
+                                        const IdxMap<type::StopPoint, DateTime>& best_labels,
+                                        const bool clockwise,
+                                        const type::GeographicalCoord& coord_origin,
+                                        const map_stop_point_duration& origin,
+                                        const double& speed,
+                                        const std::vector<DateTime>& boundary_duration,
+                                        const DateTime init_dt);
+
+// Travel times from one origin to every stop point reached by an isochrone
+struct IsochroneTravelTimes {
+    struct Item {
+        SpIdx sp_idx;
+        uint32_t duration;
+    };
+    // sorted by stop point
+    std::vector<Item> items;
+};
+
+// Compute the isochrone of every origin at the same datetime.
+// The origins are dispatched over nb_threads threads, each of them
+// having its own RAPTOR and street network worker on the same data.
+// The validity of the journey patterns and the next stop time cache
+// are computed only once and shared by every RAPTOR.
+std::vector<IsochroneTravelTimes>
+build_isochrone_batch(const type::Data& data,
+                      const std::vector<type::EntryPoint>& origins,
+                      const DateTime init_dt,
+                      const DateTime bound,
+                      uint32_t max_transfers,
+                      const type::AccessibiliteParams& accessibilite_params,
+                      const std::vector<std::string>& forbidden,
+                      const bool clockwise,
+                      const nt::RTLevel rt_level,
+                      size_t nb_threads);
+
+// Travel times to every stop point for all the departures of a time window.
+// A duration of std::numeric_limits<uint32_t>::max() means unreachable.
+struct IsochroneProfile {
+    enum class Stat { Min, Median, Percentile };
+    struct StopStats {
+        uint32_t min = std::numeric_limits<uint32_t>::max();
+        uint32_t median = std::numeric_limits<uint32_t>::max();
+        uint32_t percentile = std::numeric_limits<uint32_t>::max();
+        uint32_t get(const Stat stat) const;
+    };
+    IdxMap<type::StopPoint, StopStats> stats;
+    size_t nb_departures = 0;
+
+    explicit IsochroneProfile(const std::vector<type::StopPoint*>& stop_points): stats(stop_points) {}
+
+    // Labels as if the stat had been reached from init_dt, to be used
+    // by build_single_isochrone, build_isochrones or build_raster_isochrone
+    IdxMap<type::StopPoint, DateTime> to_labels(const std::vector<type::StopPoint*>& stop_points,
+                                                const Stat stat,
+                                                const DateTime init_dt,
+                                                const bool clockwise) const;
+};
+
+// Compute the isochrone of every departure (arrival if !clockwise) in
+// [window_begin, window_end] every step seconds. The departures are swept
+// from the last to the first (first to last if !clockwise), keeping the
+// best labels between the runs as in a range raptor.
+// percentile is in ]0, 1].
+IsochroneProfile build_isochrone_profile(RAPTOR& raptor,
+                                         const map_stop_point_duration& departures,
+                                         const DateTime window_begin,
+                                         const DateTime window_end,
+                                         const uint32_t step,
+                                         const uint32_t max_duration,
+                                         uint32_t max_transfers,
+                                         const type::AccessibiliteParams& accessibilite_params,
+                                         const std::vector<std::string>& forbidden,
+                                         const bool clockwise,
+                                         const nt::RTLevel rt_level,
+                                         const double percentile = 0.8);
+
 }} //namespace navitia::routing
@@ -52,19 +52,46 @@ std::ostream& operator<<(std::ostream& os, const JourneyPattern& jp) {
     return os << "Jp(" << jp.jpps << ", " << jp.discrete_vjs << ", " << jp.freq_vjs << ")";
 }
 
-void JourneyPatternContainer::load(const nt::PT_Data& pt_data) {
+void JourneyPatternContainer::clear(const nt::PT_Data& pt_data) {
     map.clear();
     jps.clear();
     jpps.clear();
     jps_from_route.assign(pt_data.routes);
     jp_from_vj.assign(pt_data.vehicle_journeys);
     jps_from_phy_mode.assign(pt_data.physical_modes);
+}
+
+void JourneyPatternContainer::load(const nt::PT_Data& pt_data) {
+    clear(pt_data);
     for (const auto* route: pt_data.routes) {
         for (const auto& vj: route->discrete_vehicle_journey_list) { add_vj(*vj); }
         for (const auto& vj: route->frequency_vehicle_journey_list) { add_vj(*vj); }
     }
 }
 
+std::vector<boost::optional<JpIdx>>
+JourneyPatternContainer::load(const nt::PT_Data& pt_data,
+                              const JourneyPatternContainer& previous,
+                              const boost::dynamic_bitset<>& dirty_routes) {
+    clear(pt_data);
+    std::vector<boost::optional<JpIdx>> copied_from;
+    // The routes are visited in the same order as load, and the keys
+    // contain the route, thus the jps get the same idx as with load.
+    for (const auto* route: pt_data.routes) {
+        if (dirty_routes[route->idx]) {
+            for (const auto& vj: route->discrete_vehicle_journey_list) { add_vj(*vj); }
+            for (const auto& vj: route->frequency_vehicle_journey_list) { add_vj(*vj); }
+            copied_from.resize(jps.size());
+            continue;
+        }
+        for (const auto& old_jp_idx: previous.jps_from_route[RouteIdx(*route)]) {
+            copy_jp(pt_data, previous, old_jp_idx);
+            copied_from.push_back(old_jp_idx);
+        }
+    }
+    return copied_from;
+}
+
 const JppIdx& JourneyPatternContainer::get_jpp(const type::StopTime& st) const {
     const auto& jp = get(jp_from_vj[VjIdx(*st.vehicle_journey)]);
     return jp.jpps.at(st.order());
@@ -189,6 +216,37 @@ void JourneyPatternContainer::add_vj(const VJ& vj) {
     jp_from_vj[VjIdx(vj)] = jp_idx;
 }
 
+template<typename VJ> static const VJ*
+remap_vj(const nt::PT_Data& pt_data, const VJ* vj) {
+    return static_cast<const VJ*>(pt_data.vehicle_journeys[vj->idx]);
+}
+
+JpIdx JourneyPatternContainer::copy_jp(const nt::PT_Data& pt_data,
+                                       const JourneyPatternContainer& previous,
+                                       const JpIdx& old_jp_idx) {
+    const auto& old_jp = previous.get(old_jp_idx);
+    const auto jp_idx = JpIdx(jps.size());
+    JourneyPattern jp;
+    jp.route_idx = old_jp.route_idx;
+    jp.phy_mode_idx = old_jp.phy_mode_idx;
+    for (const auto& old_jpp_idx: old_jp.jpps) {
+        const auto& old_jpp = previous.get(old_jpp_idx);
+        jp.jpps.push_back(make_jpp(jp_idx, old_jpp.sp_idx, old_jpp.order));
+    }
+    for (const auto* vj: old_jp.discrete_vjs) {
+        jp.discrete_vjs.push_back(remap_vj(pt_data, vj));
+        jp_from_vj[VjIdx(*vj)] = jp_idx;
+    }
+    for (const auto* vj: old_jp.freq_vjs) {
+        jp.freq_vjs.push_back(remap_vj(pt_data, vj));
+        jp_from_vj[VjIdx(*vj)] = jp_idx;
+    }
+    jps.push_back(std::move(jp));
+    jps_from_route[old_jp.route_idx].push_back(jp_idx);
+    jps_from_phy_mode[old_jp.phy_mode_idx].push_back(jp_idx);
+    return jp_idx;
+}
+
 JpIdx JourneyPatternContainer::make_jp(const JpKey& key) {
     const auto jp_idx = JpIdx(jps.size());
     JourneyPattern jp;
@@ -32,6 +32,7 @@ www.navitia.io
 
 #include "raptor_utils.h"
 #include <boost/optional.hpp>
+#include <boost/dynamic_bitset.hpp>
 
 namespace navitia { namespace type {
 
@@ -88,6 +89,14 @@ struct JourneyPatternContainer {
     using JppRange = boost::iterator_range<JppIterator>;
 
     void load(const navitia::type::PT_Data&);
+    // As load, but the jps of the routes not flagged in dirty_routes
+    // are copied from previous, built on an older generation of
+    // pt_data with the same routes and vjs idx (realtime only
+    // appends vjs).  Returns, for each jp, the jp of previous it has
+    // been copied from.
+    std::vector<boost::optional<JpIdx>> load(const navitia::type::PT_Data&,
+                                             const JourneyPatternContainer& previous,
+                                             const boost::dynamic_bitset<>& dirty_routes);
     size_t nb_jps() const { return jps.size(); }
     size_t nb_jpps() const { return jpps.size(); }
     const JourneyPattern& get(const JpIdx& idx) const {
@@ -180,7 +189,9 @@ private:
     IdxMap<type::VehicleJourney, JpIdx> jp_from_vj;
     IdxMap<type::PhysicalMode, std::vector<JpIdx>> jps_from_phy_mode;
 
+    void clear(const navitia::type::PT_Data&);
     template<typename VJ> void add_vj(const VJ&);
+    JpIdx copy_jp(const navitia::type::PT_Data&, const JourneyPatternContainer&, const JpIdx&);
     template<typename VJ> static JpKey make_key(const VJ&);
     JpIdx make_jp(const JpKey&);
     JppIdx make_jpp(const JpIdx&, const SpIdx&, uint16_t order);
@@ -86,6 +86,32 @@ void NextStopTimeData::TimesStopTimes<Getter>::init(const JourneyPattern& jp,
     }
 }
 
+template<typename Getter>
+void NextStopTimeData::TimesStopTimes<Getter>::copy_from(const TimesStopTimes& other,
+                                                         const type::PT_Data& pt_data) {
+    // the vjs are unchanged, thus the order is the same, only the
+    // stop times must point to the new generation
+    times = other.times;
+    stop_times.reserve(other.stop_times.size());
+    for (const auto* st: other.stop_times) {
+        const auto* vj = pt_data.vehicle_journeys[st->vehicle_journey->idx];
+        stop_times.push_back(&vj->stop_time_list[st->order()]);
+    }
+}
+
+size_t NextStopTimeData::memory_usage() const {
+    size_t res = 0;
+    for (const auto& elt: departure) {
+        res += sizeof(elt.second) + elt.second.times.capacity() * sizeof(DateTime)
+            + elt.second.stop_times.capacity() * sizeof(const type::StopTime*);
+    }
+    for (const auto& elt: arrival) {
+        res += sizeof(elt.second) + elt.second.times.capacity() * sizeof(DateTime)
+            + elt.second.stop_times.capacity() * sizeof(const type::StopTime*);
+    }
+    return res;
+}
+
 void NextStopTimeData::load(const JourneyPatternContainer& jp_container) {
     departure.assign(jp_container.get_jpps_values());
     arrival.assign(jp_container.get_jpps_values());
@@ -99,6 +125,31 @@ void NextStopTimeData::load(const JourneyPatternContainer& jp_container) {
     }
 }
 
+void NextStopTimeData::load(const JourneyPatternContainer& jp_container,
+                            const type::PT_Data& pt_data,
+                            const NextStopTimeData& previous,
+                            const JourneyPatternContainer& previous_container,
+                            const std::vector<boost::optional<JpIdx>>& copied_from) {
+    departure.assign(jp_container.get_jpps_values());
+    arrival.assign(jp_container.get_jpps_values());
+
+    for (const auto& jp: jp_container.get_jps()) {
+        const auto& old_jp_idx = copied_from.at(jp.first.val);
+        for (size_t i = 0; i < jp.second.jpps.size(); ++i) {
+            const auto& jpp_idx = jp.second.jpps[i];
+            if (old_jp_idx) {
+                const auto& old_jpp_idx = previous_container.get(*old_jp_idx).jpps[i];
+                departure[jpp_idx].copy_from(previous.departure[old_jpp_idx], pt_data);
+                arrival[jpp_idx].copy_from(previous.arrival[old_jpp_idx], pt_data);
+            } else {
+                const auto& jpp = jp_container.get(jpp_idx);
+                departure[jpp_idx].init(jp.second, jpp);
+                arrival[jpp_idx].init(jp.second, jpp);
+            }
+        }
+    }
+}
+
 inline static bool
 is_valid(const type::StopTime* st,
         const DateTime date,
@@ -454,7 +505,20 @@ CachedNextStopTime CachedNextStopTimeManager::CacheCreator::operator()(const Cac
     for (const auto& jpp_dtst : departure) {
         boost::sort(jpp_dtst.second, compare);
     }
-    return {departure, arrival};
+    CachedNextStopTime res(departure, arrival);
+    ++stats->nb_created;
+    stats->last_size = sizeof(res) + res.memory_usage();
+    return res;
+}
+
+size_t CachedNextStopTimeManager::memory_usage() const {
+    return stats->last_size * std::min(stats->nb_created.load(), max_cache);
+}
+
+size_t CachedNextStopTime::DtStFromJpp::memory_usage() const {
+    size_t res = dtsts.capacity() * sizeof(DtSt);
+    for (const auto& elt: until) { res += sizeof(elt.second); }
+    return res;
 }
 
 CachedNextStopTime::DtStFromJpp::DtStFromJpp(const vDtStByJpp& map) {
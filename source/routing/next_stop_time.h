@@ -41,6 +41,8 @@ www.navitia.io
 #include <boost/range/algorithm/upper_bound.hpp>
 #include <boost/optional.hpp>
 #include <boost/dynamic_bitset.hpp>
+#include <atomic>
+#include <memory>
 
 namespace navitia {
 
@@ -62,6 +64,17 @@ struct NextStopTimeData {
     typedef boost::iterator_range<std::vector<const type::StopTime*>::const_reverse_iterator> StopTimeReverseIter;
 
     void load(const JourneyPatternContainer&);
+    // As load, but the jpps of the jps copied from previous_container
+    // (see JourneyPatternContainer::load) reuse the sorted stop times
+    // of previous, remapped to pt_data.
+    void load(const JourneyPatternContainer&,
+              const type::PT_Data&,
+              const NextStopTimeData& previous,
+              const JourneyPatternContainer& previous_container,
+              const std::vector<boost::optional<JpIdx>>& copied_from);
+
+    // estimated size in bytes of the sorted stop times
+    size_t memory_usage() const;
 
     // Returns the range of the stop times in increasing time order
     inline StopTimeIter stop_time_range_forward(const JppIdx jpp_idx,
@@ -138,6 +151,7 @@ private:
             return boost::make_iterator_range(stop_times.rend() - idx, stop_times.rend());
         }
         void init(const JourneyPattern& jp, const JourneyPatternPoint& jpp);
+        void copy_from(const TimesStopTimes& other, const type::PT_Data& pt_data);
     };
     IdxMap<JourneyPatternPoint, TimesStopTimes<Departure>> departure;
     IdxMap<JourneyPatternPoint, TimesStopTimes<Arrival>> arrival;
@@ -228,11 +242,14 @@ struct CachedNextStopTime {
                    const DateTime dt,
                    const bool clockwise) const;
 
+    size_t memory_usage() const { return departure.memory_usage() + arrival.memory_usage(); }
+
 private:
     // This structure provide the same interface as a vDtStByJpp, but
     // in a condensed and read only view.
     struct DtStFromJpp {
         DtStFromJpp(const vDtStByJpp& map);
+        size_t memory_usage() const;
 
         // Returns the range corresponding to map[jpp_idx], i.e. from
         // dtsts[until[prev(jpp_idx)]] to dtsts[until[jpp_idx]]
@@ -268,7 +285,7 @@ private:
 
 struct CachedNextStopTimeManager {
     explicit CachedNextStopTimeManager(const dataRAPTOR& dataRaptor, size_t max_cache) :
-            lru({dataRaptor}, max_cache) {}
+            max_cache(max_cache), lru(CacheCreator(dataRaptor, stats), max_cache) {}
     CachedNextStopTimeManager& operator=(CachedNextStopTimeManager&&) = default;
     ~CachedNextStopTimeManager();
 
@@ -277,15 +294,26 @@ struct CachedNextStopTimeManager {
          const type::RTLevel rt_level,
          const type::AccessibiliteParams& accessibilite_params);
 
+    // estimated size in bytes of the caches: the lru doesn't give
+    // them, they are supposed to be as big as the last created one
+    size_t memory_usage() const;
+
 private:
+    struct CacheStats {
+        std::atomic<size_t> nb_created{0};
+        std::atomic<size_t> last_size{0};
+    };
     struct CacheCreator {
         typedef CachedNextStopTimeKey const& argument_type;
         typedef CachedNextStopTime result_type;
         const dataRAPTOR& dataRaptor;
-        CacheCreator(const dataRAPTOR& d): dataRaptor(d) {}
+        std::shared_ptr<CacheStats> stats;
+        CacheCreator(const dataRAPTOR& d, std::shared_ptr<CacheStats> s): dataRaptor(d), stats(std::move(s)) {}
         CachedNextStopTime operator()(const CachedNextStopTimeKey& key) const;
     };
 
+    size_t max_cache;
+    std::shared_ptr<CacheStats> stats = std::make_shared<CacheStats>();
     ConcurrentLru<CacheCreator> lru;
 };
 
@@ -31,6 +31,7 @@ www.navitia.io
 #include "raptor_solution_reader.h"
 #include "raptor.h"
 #include "raptor_visitors.h"
+#include "type/tracing.h"
 #include <boost/range/algorithm_ext/push_back.hpp>
 #include <boost/range/adaptor/filtered.hpp>
 #include <boost/range/algorithm/find_if.hpp>
@@ -105,15 +106,15 @@ bool RAPTOR::foot_path(const Visitor& v) {
                 data.dataRaptor->connections.forward_connections :
                 data.dataRaptor->connections.backward_connections;
 
-    for (const auto sp_cnx: cnx_list) {
+    for (size_t sp = 0; sp < cnx_list.nb_stop_points(); ++sp) {
         // for all stop point, we check if we can improve the stop points they are in connection with
-        const auto& sp_idx = sp_cnx.first;
+        const SpIdx sp_idx(sp);
 
         if (! working_labels.pt_is_initialized(sp_idx)) { continue; }
 
         const DateTime previous = working_labels.dt_pt(sp_idx);
 
-        for (const auto& conn: sp_cnx.second) {
+        for (const auto& conn: cnx_list[sp_idx]) {
             const SpIdx destination_sp_idx = conn.sp_idx;
             const DateTime next = v.combine(previous, conn.duration);
 
@@ -141,7 +142,7 @@ bool RAPTOR::foot_path(const Visitor& v) {
 }
 
 
-void RAPTOR::clear(const bool clockwise, const DateTime bound) {
+void RAPTOR::clear_rounds(const bool clockwise) {
     const int queue_value = clockwise ?  std::numeric_limits<int>::max() : -1;
     Q.assign(data.dataRaptor->jp_container.get_jps_values(), queue_value);
     if (labels.empty()) {
@@ -152,6 +153,10 @@ void RAPTOR::clear(const bool clockwise, const DateTime bound) {
     for(auto& lbl_list : labels) {
         lbl_list.clear(clean_labels);
     }
+}
+
+void RAPTOR::clear(const bool clockwise, const DateTime bound) {
+    clear_rounds(clockwise);
 
     boost::fill(best_labels_pts.values(), bound);
     boost::fill(best_labels_transfers.values(), bound);
@@ -384,6 +389,7 @@ RAPTOR::compute_all(const map_stop_point_duration& departures,
                     bool clockwise,
                     const boost::optional<navitia::time_duration>& direct_path_dur,
                     const size_t max_extra_second_pass) {
+    tracing::Span span("raptor.compute_all");
     auto start_raptor = std::chrono::system_clock::now();
 
     auto solutions = ParetoFront<Journey, Dominates/*, JourneyParetoFrontVisitor*/>(Dominates(clockwise));
@@ -404,8 +410,11 @@ RAPTOR::compute_all(const map_stop_point_duration& departures,
     const auto& calc_dep = clockwise ? departures : destinations;
     const auto& calc_dest = clockwise ? destinations : departures;
 
-    first_raptor_loop(calc_dep, departure_datetime, rt_level,
-                      bound, max_transfers, accessibilite_params, forbidden_uri, clockwise);
+    {
+        tracing::Span first_pass_span("raptor.first_pass");
+        first_raptor_loop(calc_dep, departure_datetime, rt_level,
+                          bound, max_transfers, accessibilite_params, forbidden_uri, clockwise);
+    }
 
     auto end_first_pass = std::chrono::system_clock::now();
 
@@ -453,14 +462,18 @@ RAPTOR::compute_all(const map_stop_point_duration& departures,
 
         const auto& working_labels = first_pass_labels[start.count];
 
-        clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
-        map_stop_point_duration init_map;
-        init_map[start.sp_idx] = 0_s;
-        best_labels_pts = best_labels_pts_for_snd_pass;
-        best_labels_transfers = best_labels_transfers_for_snd_pass;
-        init(init_map, working_labels.dt_pt(start.sp_idx),
-             !clockwise, accessibilite_params.properties);
-        boucleRAPTOR(!clockwise, rt_level, max_transfers);
+        {
+            tracing::Span second_pass_span("raptor.second_pass");
+            clear(!clockwise, departure_datetime + (clockwise ? -1 : 1));
+            map_stop_point_duration init_map;
+            init_map[start.sp_idx] = 0_s;
+            best_labels_pts = best_labels_pts_for_snd_pass;
+            best_labels_transfers = best_labels_transfers_for_snd_pass;
+            init(init_map, working_labels.dt_pt(start.sp_idx),
+                 !clockwise, accessibilite_params.properties);
+            boucleRAPTOR(!clockwise, rt_level, max_transfers);
+        }
+        tracing::Span read_span("raptor.read_solutions");
         read_solutions(*this,
                        solutions,
                        !clockwise,
@@ -502,6 +515,16 @@ RAPTOR::isochrone(const map_stop_point_duration& departures,
                   const std::vector<std::string>& forbidden,
                   bool clockwise,
                   const nt::RTLevel rt_level) {
+    init_isochrone(departure_datetime, b, accessibilite_params, forbidden, clockwise, rt_level);
+    run_isochrone(departures, departure_datetime, b, max_transfers, accessibilite_params, clockwise, rt_level);
+}
+
+void RAPTOR::init_isochrone(const DateTime& departure_datetime,
+                            const DateTime& b,
+                            const type::AccessibiliteParams& accessibilite_params,
+                            const std::vector<std::string>& forbidden,
+                            bool clockwise,
+                            const nt::RTLevel rt_level) {
     const DateTime bound = limit_bound(clockwise, departure_datetime, b);
     set_valid_jp_and_jpp(DateTimeUtils::date(departure_datetime),
                          accessibilite_params,
@@ -512,13 +535,42 @@ RAPTOR::isochrone(const map_stop_point_duration& departures,
         clockwise ? departure_datetime : bound,
         rt_level,
         accessibilite_params);
+}
 
+void RAPTOR::share_isochrone_init(const RAPTOR& other) {
+    assert(&data == &other.data);
+    valid_journey_patterns = other.valid_journey_patterns;
+    valid_stop_points = other.valid_stop_points;
+    jpps_from_sp = other.jpps_from_sp;
+    next_st = other.next_st;
+}
+
+void RAPTOR::run_isochrone(const map_stop_point_duration& departures,
+                           const DateTime& departure_datetime,
+                           const DateTime& b,
+                           uint32_t max_transfers,
+                           const type::AccessibiliteParams& accessibilite_params,
+                           bool clockwise,
+                           const nt::RTLevel rt_level) {
+    const DateTime bound = limit_bound(clockwise, departure_datetime, b);
     clear(clockwise, bound);
     init(departures, departure_datetime, clockwise, accessibilite_params.properties);
 
     boucleRAPTOR(clockwise, rt_level, max_transfers);
 }
 
+void RAPTOR::rerun_isochrone(const map_stop_point_duration& departures,
+                             const DateTime& departure_datetime,
+                             uint32_t max_transfers,
+                             const type::AccessibiliteParams& accessibilite_params,
+                             bool clockwise,
+                             const nt::RTLevel rt_level) {
+    clear_rounds(clockwise);
+    init(departures, departure_datetime, clockwise, accessibilite_params.properties);
+
+    boucleRAPTOR(clockwise, rt_level, max_transfers);
+}
+
 // Returns valid_jpps
 void RAPTOR::set_valid_jp_and_jpp(
     uint32_t date,
@@ -108,6 +108,9 @@ struct RAPTOR
 
     void clear(bool clockwise, DateTime bound);
 
+    /// Clear the labels of every round, but not the best labels
+    void clear_rounds(bool clockwise);
+
     ///Initialize starting points
     void init(const map_stop_point_duration& dep,
               const DateTime bound,
@@ -168,6 +171,42 @@ struct RAPTOR
               bool clockwise = true,
               const nt::RTLevel rt_level = nt::RTLevel::Base);
 
+    /// Prepare what only depends on the date and the filters of an
+    /// isochrone: the valid journey patterns and stop points, and the
+    /// next stop time cache.
+    void init_isochrone(const DateTime& departure_datetime,
+                        const DateTime& bound,
+                        const type::AccessibiliteParams& accessibilite_params,
+                        const std::vector<std::string>& forbidden,
+                        bool clockwise,
+                        const nt::RTLevel rt_level);
+
+    /// Same as run_isochrone, but keeps the best labels of the
+    /// previous run.  Calling it with decreasing departure datetimes
+    /// (increasing arrival datetimes if not clockwise) is a range
+    /// raptor: the labels found for a later departure are valid
+    /// bounds for an earlier one.
+    void rerun_isochrone(const map_stop_point_duration& departures,
+                         const DateTime& departure_datetime,
+                         uint32_t max_transfers,
+                         const type::AccessibiliteParams& accessibilite_params,
+                         bool clockwise,
+                         const nt::RTLevel rt_level);
+
+    /// Reuse what has been prepared by init_isochrone on another
+    /// RAPTOR working on the same data
+    void share_isochrone_init(const RAPTOR& other);
+
+    /// Compute the isochrone, init_isochrone or share_isochrone_init
+    /// must have been called before
+    void run_isochrone(const map_stop_point_duration& departures,
+                       const DateTime& departure_datetime,
+                       const DateTime& bound,
+                       uint32_t max_transfers,
+                       const type::AccessibiliteParams& accessibilite_params,
+                       bool clockwise,
+                       const nt::RTLevel rt_level);
+
 
     /// Désactive les journey_patterns qui n'ont pas de vj valides la veille, le jour, et le lendemain du calcul
     /// Gère également les lignes, modes, journey_patterns et VJ interdits
@@ -34,6 +34,7 @@ www.navitia.io
 #include "type/pb_converter.h"
 #include "type/datetime.h"
 #include "type/meta_data.h"
+#include "type/tracing.h"
 #include "fare/fare.h"
 #include "isochrone.h"
 #include "heat_map.h"
@@ -86,8 +87,8 @@ static void fill_shape(pbnavitia::Section* pb_section,
         // As every stop times may not be present (because they can be
         // filtered because of estimated datetime), we can only print
         // the shape if the 2 stop times are consecutive
-        if (prev_order + 1 == cur_order && st-> shape_from_prev != nullptr) {
-            for (const auto& cur_coord: *st->shape_from_prev) {
+        if (prev_order + 1 == cur_order && st->shape_from_prev() != nullptr) {
+            for (const auto& cur_coord: *st->shape_from_prev()) {
                 if (cur_coord == prev_coord) { continue; }
                 add_coord(cur_coord, pb_section);
                 prev_coord = cur_coord;
@@ -229,6 +230,7 @@ static georef::Path get_direct_path(georef::StreetNetwork& worker,
     if (! origin.streetnetwork_params.enable_direct_path) { //(direct path use only origin mode)
         return georef::Path();
     }
+    tracing::Span span("direct_path");
     return worker.get_direct_path(origin, destination);
 }
 
@@ -682,6 +684,7 @@ make_pathes(PbCreator& pb_creator,
             const type::EntryPoint& destination,
             const std::vector<bt::ptime>& datetimes,
             const bool clockwise) {
+    tracing::Span span("pb_creator.make_pathes");
 
     pb_creator.set_response_type(pbnavitia::ITINERARY_FOUND);
     add_pathes(pb_creator, paths, worker, direct_path,
@@ -859,7 +862,7 @@ get_stop_points( const type::EntryPoint &ep, const type::Data& data,
         //we need to check if the admin has zone odt
         const auto& admins = find_admins(ep, data);
         for (const auto* admin: admins) {
-            for (const auto* odt_admin_stop_point: admin->odt_stop_points) {
+            for (const auto* odt_admin_stop_point: data.pt_data->get_odt_stop_points(*admin)) {
                 const SpIdx sp_idx{*odt_admin_stop_point};
                 if (result.find(sp_idx) == result.end()) {
                     concerned_path_finder.distance_to_entry_point[sp_idx] = {};
@@ -911,8 +914,9 @@ get_stop_points( const type::EntryPoint &ep, const type::Data& data,
         for (const auto& elt: nearest) {
             result[SpIdx{elt.first}] = elt.second;
         }
-        if (! admin->main_stop_areas.empty()) {
-            for (auto stop_area: admin->main_stop_areas) {
+        const auto& main_stop_areas = data.pt_data->get_main_stop_areas(*admin);
+        if (! main_stop_areas.empty()) {
+            for (auto stop_area: main_stop_areas) {
                 for(auto sp : stop_area->stop_point_list) {
                     const SpIdx sp_idx{*sp};
                     result[sp_idx] = {};
@@ -1033,6 +1037,7 @@ make_response(RAPTOR &raptor,
               uint32_t max_duration,
               uint32_t max_transfers,
               uint32_t max_extra_second_pass) {
+    tracing::Span span("make_response");
 
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     PbCreator pb_creator(raptor.data, current_datetime, null_time_period);
@@ -1044,8 +1049,12 @@ make_response(RAPTOR &raptor,
         return pb_creator.get_response();
     }
     worker.init(origin, {destination});
-    auto departures = get_stop_points(origin, raptor.data, worker);
-    auto destinations = get_stop_points(destination, raptor.data, worker, true);
+    routing::map_stop_point_duration departures, destinations;
+    {
+        tracing::Span span("entry_points");
+        departures = get_stop_points(origin, raptor.data, worker);
+        destinations = get_stop_points(destination, raptor.data, worker, true);
+    }
     const auto direct_path = get_direct_path(worker, origin, destination);
 
     if(departures.size() == 0 && destinations.size() == 0){
@@ -1170,6 +1179,30 @@ pbnavitia::Response make_isochrone(RAPTOR &raptor,
     return pb_creator.get_response();
 }
 
+std::vector<IsochroneTravelTimes>
+make_isochrone_batch(const type::Data& data,
+                     const std::vector<type::EntryPoint>& origins,
+                     const uint64_t datetime_timestamp,
+                     bool clockwise,
+                     const type::AccessibiliteParams& accessibilite_params,
+                     const std::vector<std::string>& forbidden,
+                     const type::RTLevel rt_level,
+                     size_t nb_threads,
+                     int max_duration,
+                     uint32_t max_transfers) {
+    const bt::ptime datetime = bt::from_time_t(datetime_timestamp);
+    if (! data.meta->production_date.contains(datetime.date())) {
+        throw IsochroneException("date is not in data production period");
+    }
+    int day = (datetime.date() - data.meta->production_date.begin()).days();
+    int time = datetime.time_of_day().total_seconds();
+    DateTime init_dt = DateTimeUtils::set(day, time);
+    DateTime bound = build_bound(clockwise, max_duration, init_dt);
+
+    return build_isochrone_batch(data, origins, init_dt, bound, max_transfers,
+                                 accessibilite_params, forbidden, clockwise, rt_level, nb_threads);
+}
+
 static void print_coord(std::stringstream& ss,
                         const type::GeographicalCoord coord) {
     ss << std::setprecision(15) << "[" << coord.lon() << "," << coord.lat() << "]";
@@ -1342,7 +1375,8 @@ pbnavitia::Response make_heat_map(RAPTOR &raptor,
     if (resp) {
         return *resp;
     }
-    auto heat_map = build_raster_isochrone(worker.geo_ref, speed, mode, isochrone_common.init_dt, raptor,
+    auto heat_map = build_raster_isochrone(worker.geo_ref, worker.projected_stop_points, speed, mode,
+                                           isochrone_common.init_dt, raptor,
                                            isochrone_common.coord_origin, max_duration, clockwise,
                                            isochrone_common.bound, resolution);
     add_heat_map(heat_map, pb_creator, center, clockwise, isochrone_common.datetime);
@@ -53,6 +53,7 @@ namespace navitia{
 namespace navitia { namespace routing {
 
 struct RAPTOR;
+struct IsochroneTravelTimes;
 
 void add_direct_path(PbCreator& pb_creator,
                      const georef::Path& path,
@@ -87,6 +88,20 @@ pbnavitia::Response make_isochrone(RAPTOR &raptor,
                                    int max_duration = 3600,
                                    uint32_t max_transfers=std::numeric_limits<uint32_t>::max());
 
+// Isochrones of several origins leaving at the same datetime, computed
+// in parallel, see build_isochrone_batch
+std::vector<IsochroneTravelTimes>
+make_isochrone_batch(const type::Data& data,
+                     const std::vector<type::EntryPoint>& origins,
+                     const uint64_t datetime,
+                     bool clockwise,
+                     const type::AccessibiliteParams& accessibilite_params,
+                     const std::vector<std::string>& forbidden,
+                     const type::RTLevel rt_level,
+                     size_t nb_threads,
+                     int max_duration = 3600,
+                     uint32_t max_transfers=std::numeric_limits<uint32_t>::max());
+
 pbnavitia::Response make_pt_response(RAPTOR &raptor,
                                      const std::vector<type::EntryPoint> &origins,
                                      const std::vector<type::EntryPoint> &destinations,
@@ -121,7 +121,7 @@ void align_left(const RaptorSolutionReader<Visitor>& reader, Journey& j) {
     const auto* prev_s = &j.sections.at(0);
     for (auto& cur_s: boost::make_iterator_range(j.sections.begin() + 1, j.sections.end() - 1)) {
         const auto& cur_jpp_idx = jp_container.get_jpp(*cur_s.get_in_st);
-        const auto* conn = reader.raptor.data.pt_data->get_stop_point_connection(
+        const auto* conn = reader.raptor.data.dataRaptor->get_connection(
             *prev_s->get_out_st->stop_point,
             *cur_s.get_in_st->stop_point);
         assert(conn != nullptr);
@@ -165,10 +165,10 @@ uint8_t count_vj_extentions(const Journey& j) {
 }
 
 std::pair<navitia::time_duration, navitia::time_duration>
-get_transfer_waiting(const type::PT_Data& data,
+get_transfer_waiting(const dataRAPTOR& data,
                      const Journey::Section& from,
                      const Journey::Section& to) {
-    const auto* conn = data.get_stop_point_connection(
+    const auto* conn = data.get_connection(
         *from.get_out_st->stop_point,
         *to.get_in_st->stop_point);
     assert(conn);
@@ -227,7 +227,7 @@ const Journey& make_journey(const PathElt& path, RaptorSolutionReader<Visitor>&
     // transfer objectives
     j.transfer_dur = reader.transfer_penalty * (j.sections.size() + j.nb_vj_extentions);
     if (j.sections.size() > 1) {
-        const auto& data = *reader.raptor.data.pt_data;
+        const auto& data = *reader.raptor.data.dataRaptor;
         const auto first_transfer_waiting = get_transfer_waiting(data, j.sections[0], j.sections[1]);
         j.transfer_dur += first_transfer_waiting.first;
         j.min_waiting_dur = first_transfer_waiting.second;
@@ -695,8 +695,8 @@ Path make_path(const Journey& journey, const type::Data& data) {
             auto waiting_section_start = posix(last_section->get_out_dt);
             const auto previous_stop = last_section->get_out_st->stop_point;
 
-            const auto* conn = data.pt_data->get_stop_point_connection(
-                        *previous_stop, *dep_stop_point);
+            // the transfer can be a chain of connections, with the transfer closure
+            const auto* conn = data.dataRaptor->get_connection(*previous_stop, *dep_stop_point);
             assert(conn);
 
             const auto end_of_transfer = posix(last_section->get_out_dt + conn->display_duration);
@@ -711,13 +711,13 @@ Path make_path(const Journey& journey, const type::Data& data) {
                 s.stop_points.push_back(previous_stop);
                 s.stop_points.push_back(dep_stop_point);
 
-                s.connection = conn;
+                s.connection = data.pt_data->get_stop_point_connection(*previous_stop, *dep_stop_point);
                 waiting_section_start = end_of_transfer; //we update the start of the waiting section
             }
 
             const auto transfer_time = section.get_in_dt - last_section->get_out_dt;
             //if the transfer is bigger than the actual connection, we add a waiting section
-            if (conn->display_duration < int(transfer_time) || ! walking_transfer) {
+            if (int(conn->display_duration) < int(transfer_time) || ! walking_transfer) {
                 path.items.emplace_back(ItemType::waiting,
                                         waiting_section_start,
                                         posix(section.get_in_dt));
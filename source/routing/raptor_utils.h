@@ -33,6 +33,7 @@ www.navitia.io
 #include <boost/container/flat_map.hpp>
 #include "type/datetime.h"
 #include "utils/idx_map.h"
+#include "type/arena.h"
 
 namespace navitia {
 
@@ -57,7 +58,9 @@ using VjIdx = Idx<type::VehicleJourney>;
 using MvjIdx = Idx<type::MetaVehicleJourney>;
 using PhyModeIdx = Idx<type::PhysicalMode>;
 
-using map_stop_point_duration = boost::container::flat_map<SpIdx, navitia::time_duration>;
+// in the arena of the request when there is one, see Worker::dispatch
+using map_stop_point_duration = boost::container::flat_map<SpIdx, navitia::time_duration, std::less<SpIdx>,
+    ArenaAllocator<std::pair<SpIdx, navitia::time_duration>>>;
 
 inline bool is_dt_initialized(const DateTime dt) {
     return dt != DateTimeUtils::inf && dt != DateTimeUtils::min;
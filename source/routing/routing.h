@@ -91,6 +91,7 @@ struct PathItem {
      */
     std::vector<const navitia::type::StopPoint*> stop_points;
 
+    /// nullptr for a transfer chaining several connections
     const navitia::type::StopPointConnection* connection;
 
     ItemType type;
@@ -60,7 +60,7 @@ namespace navitia { namespace cli {
                 return false;
             }
             bool clockwise = !vm.count("counterclockwise");
-            navitia::georef::StreetNetwork sn_worker(*raptor->data.geo_ref);
+            navitia::georef::StreetNetwork sn_worker(*raptor->data.geo_ref, *raptor->data.projected_stop_points);
 
             
             nt::Type_e origin_type = raptor->data.get_type_of_id(start);
@@ -74,7 +74,7 @@ BOOST_AUTO_TEST_CASE(co2_emission_higher_0) {
     navitia::type::EntryPoint origin(origin_type, "stop_area:stop1");
     navitia::type::EntryPoint destination(destination_type, "stop_area:stop2");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {ntest::to_posix_timestamp("20120614T021000")},
                                              true, navitia::type::AccessibiliteParams(), forbidden, sn_worker,
                                              nt::RTLevel::Base, boost::gregorian::not_a_date_time, 2_min);
@@ -114,7 +114,7 @@ BOOST_AUTO_TEST_CASE(co2_emission_equal_0) {
     navitia::type::EntryPoint origin(origin_type, "stop_area:stop1");
     navitia::type::EntryPoint destination(destination_type, "stop_area:stop2");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {ntest::to_posix_timestamp("20120614T021000")},
                                              true, navitia::type::AccessibiliteParams(), forbidden, sn_worker,
                                              nt::RTLevel::Base, boost::gregorian::not_a_date_time, 2_min);
@@ -152,7 +152,7 @@ BOOST_AUTO_TEST_CASE(co2_emission_lower_0) {
     navitia::type::EntryPoint origin(origin_type, "stop_area:stop1");
     navitia::type::EntryPoint destination(destination_type, "stop_area:stop2");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {ntest::to_posix_timestamp("20120614T021000")},
                                              true, navitia::type::AccessibiliteParams(), forbidden, sn_worker,
                                              nt::RTLevel::Base, boost::gregorian::not_a_date_time, 2_min);
@@ -177,7 +177,7 @@ BOOST_AUTO_TEST_CASE(heat_map_test) {
     const double speed = 0.8;
     const uint resolution = 100;
     auto stop_points = raptor.data.pt_data->stop_points;
-    (*b.data->geo_ref).project_stop_points(stop_points);
+    const auto projected_stop_points = b.data->geo_ref->project_stop_points(stop_points);
     const auto max_duration = 36000;
     size_t step = 3;
     auto box = BoundBox();
@@ -190,7 +190,7 @@ BOOST_AUTO_TEST_CASE(heat_map_test) {
     auto mode = navitia::type::Mode_e::Walking;
     const auto bound = navitia::DateTimeUtils::set(0, "09:00"_t);
     const auto init_dt = navitia::DateTimeUtils::set(0, "07:00"_t);
-    const auto isochrone= build_raster_isochrone(*b.data->geo_ref, speed, mode,
+    const auto isochrone= build_raster_isochrone(*b.data->geo_ref, projected_stop_points, speed, mode,
                                                  init_dt,raptor, A, max_duration,
                                                  true, bound, resolution);
     BOOST_CHECK(isochrone.size() > 0);
@@ -201,7 +201,7 @@ BOOST_AUTO_TEST_CASE(heat_map_test) {
     std::size_t found_body = isochrone.find(body);
     BOOST_CHECK(found_body != std::string::npos);
 #if BOOST_VERSION >= 105500
-    auto distances = init_distance(*b.data->geo_ref, stop_points, init_dt, raptor,
+    auto distances = init_distance(*b.data->geo_ref, projected_stop_points, stop_points, init_dt, raptor,
                                    mode, E, true, bound, speed, max_duration);
     auto heat_map = fill_heat_map(box,  height_step, width_step, *b.data->geo_ref,
                                   min_dist,  max_duration, speed, distances, step);
@@ -227,3 +227,45 @@ BOOST_AUTO_TEST_CASE(build_ischrons_test) {
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30[0].shape, isochrone_8h_8h30_9h[0].shape));
     BOOST_CHECK(boost::geometry::equals(isochrone_8h30_9h[0].shape, isochrone_8h_8h30_9h[1].shape));
 }
+
+BOOST_AUTO_TEST_CASE(build_isochrone_profile_test) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", "08:00"_t)("stop2", "08:10"_t)("stop3", "08:20"_t);
+    b.vj("B")("stop1", "08:20"_t)("stop2", "08:30"_t);
+    b.connection("stop1", "stop1", 120);
+    b.connection("stop2", "stop2", 120);
+    b.connection("stop3", "stop3", 120);
+    b.data->pt_data->index();
+    b.finish();
+    b.data->build_raptor();
+    RAPTOR raptor(*b.data);
+    navitia::routing::map_stop_point_duration d;
+    d.emplace(navitia::routing::SpIdx(*b.sps["stop1"]), navitia::seconds(0));
+    // departures at 07:50, 08:00, 08:10 and 08:20
+    const auto profile = build_isochrone_profile(raptor, d,
+                                                 navitia::DateTimeUtils::set(0, "07:50"_t),
+                                                 navitia::DateTimeUtils::set(0, "08:20"_t),
+                                                 10 * 60, 3600, 10, navitia::type::AccessibiliteParams(), {}, true,
+                                                 navitia::type::RTLevel::Base);
+    BOOST_CHECK_EQUAL(profile.nb_departures, 4);
+    const auto& stop1 = profile.stats[navitia::routing::SpIdx(*b.sps["stop1"])];
+    BOOST_CHECK_EQUAL(stop1.min, 0);
+    BOOST_CHECK_EQUAL(stop1.percentile, 0);
+    // 20, 10, 20 and 10 minutes
+    const auto& stop2 = profile.stats[navitia::routing::SpIdx(*b.sps["stop2"])];
+    BOOST_CHECK_EQUAL(stop2.min, 10 * 60);
+    BOOST_CHECK_EQUAL(stop2.median, 10 * 60);
+    BOOST_CHECK_EQUAL(stop2.percentile, 20 * 60);
+    // 30 and 20 minutes, unreachable after 08:00
+    const auto& stop3 = profile.stats[navitia::routing::SpIdx(*b.sps["stop3"])];
+    BOOST_CHECK_EQUAL(stop3.min, 20 * 60);
+    BOOST_CHECK_EQUAL(stop3.median, 30 * 60);
+    BOOST_CHECK_EQUAL(stop3.percentile, std::numeric_limits<uint32_t>::max());
+
+    const auto init_dt = navitia::DateTimeUtils::set(0, "08:00"_t);
+    const auto labels = profile.to_labels(b.data->pt_data->stop_points, navitia::routing::IsochroneProfile::Stat::Median, init_dt, true);
+    BOOST_CHECK_EQUAL(labels[navitia::routing::SpIdx(*b.sps["stop3"])],
+                      navitia::DateTimeUtils::set(0, "08:30"_t));
+    const auto labels_pct = profile.to_labels(b.data->pt_data->stop_points, navitia::routing::IsochroneProfile::Stat::Percentile, init_dt, true);
+    BOOST_CHECK_EQUAL(labels_pct[navitia::routing::SpIdx(*b.sps["stop3"])], navitia::DateTimeUtils::inf);
+}
@@ -32,9 +32,11 @@ www.navitia.io
 #define BOOST_TEST_MODULE journey_pattern_container_test
 
 #include "routing/journey_pattern_container.h"
+#include "routing/dataraptor.h"
 #include "ed/build_helper.h"
 #include "tests/utils_test.h"
 #include "type/pt_data.h"
+#include "type/data.h"
 #include <boost/test/unit_test.hpp>
 
 namespace nr = navitia::routing;
@@ -247,3 +249,61 @@ BOOST_AUTO_TEST_CASE(lightly_overtaking2) {
     BOOST_CHECK_EQUAL(jps.nb_jps(), 2);
 }
 
+
+// the incremental load on a modified clone must give the same result
+// as a full load, the unmodified routes pointing to the clone
+BOOST_AUTO_TEST_CASE(incremental_load_on_clone) {
+    ed::builder b("20150101");
+    b.vj("1", "000111")("A", "8:00"_t, "8:00"_t)("B", "8:10"_t, "8:10"_t);
+    b.vj("1", "000111")("A", "8:05"_t, "8:05"_t)("B", "8:15"_t, "8:15"_t);
+    b.vj("2", "000111")("C", "9:00"_t, "9:00"_t)("D", "9:10"_t, "9:10"_t);
+    b.vj("3", "001100")("E", "9:00"_t, "9:00"_t)("F", "9:10"_t, "9:10"_t);
+
+    b.data->pt_data->index();
+    b.finish();
+    b.data->build_raptor();
+    b.data->build_uri();
+
+    nt::Data clone;
+    clone.clone_from(*b.data);
+    // as a realtime cancellation of the vj of the line 2
+    auto* vj = clone.pt_data->vehicle_journeys_map.at(b.data->pt_data->vehicle_journeys[2]->uri);
+    auto* empty_vp = clone.pt_data->get_or_create_validity_pattern(
+        nt::ValidityPattern(vj->validity_patterns[nt::RTLevel::Base]->beginning_date));
+    vj->validity_patterns[nt::RTLevel::RealTime] = empty_vp;
+
+    const nt::PT_Data& d = *clone.pt_data;
+    nr::JourneyPatternContainer jps;
+    boost::dynamic_bitset<> dirty_routes(d.routes.size());
+    dirty_routes.set(vj->route->idx);
+    const auto copied_from = jps.load(d, b.data->dataRaptor->jp_container, dirty_routes);
+    BOOST_CHECK_EQUAL(check_jp_container(jps), 4);
+    BOOST_REQUIRE_EQUAL(copied_from.size(), jps.nb_jps());
+    for (const auto& jp: jps.get_jps()) {
+        const bool is_dirty = jp.second.route_idx == nr::RouteIdx(*vj->route);
+        BOOST_CHECK_EQUAL(bool(copied_from[jp.first.val]), ! is_dirty);
+        jp.second.for_each_vehicle_journey([&](const nt::VehicleJourney& jp_vj) {
+            BOOST_CHECK_EQUAL(&jp_vj, d.vehicle_journeys[jp_vj.idx]);
+            return true;
+        });
+    }
+
+    clone.build_raptor(*b.data);
+    nr::dataRAPTOR full;
+    full.load(d);
+    const auto& incremental = *clone.dataRaptor;
+    BOOST_CHECK_EQUAL(incremental.jp_container.nb_jps(), full.jp_container.nb_jps());
+    for (const auto& jp: full.jp_container.get_jps()) {
+        BOOST_CHECK_EQUAL(incremental.jp_container.get(jp.first), jp.second);
+    }
+    for (const auto level: {nt::RTLevel::Base, nt::RTLevel::Adapted, nt::RTLevel::RealTime}) {
+        BOOST_CHECK(incremental.jp_validity_patterns[level] == full.jp_validity_patterns[level]);
+    }
+    for (const auto& jpp: full.jp_container.get_jpps()) {
+        const auto range = full.next_stop_time_data.stop_time_range_forward(jpp.first, nr::StopEvent::pick_up);
+        const auto inc_range =
+            incremental.next_stop_time_data.stop_time_range_forward(jpp.first, nr::StopEvent::pick_up);
+        BOOST_CHECK(std::vector<const nt::StopTime*>(range.begin(), range.end())
+                    == std::vector<const nt::StopTime*>(inc_range.begin(), inc_range.end()));
+    }
+}
@@ -3006,3 +3006,37 @@ BOOST_AUTO_TEST_CASE(forbidden_uri_1) {
     BOOST_CHECK_EQUAL(res2.at(0).items.at(3).stop_points.front()->uri, chatelet);
 }
 
+
+// stop2 -> stop3 -> stop4 needs two connections, that can only be done
+// in one transfer with the transfer closure
+BOOST_AUTO_TEST_CASE(transfer_closure) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", "08:00"_t)("stop2", "08:10"_t);
+    b.vj("B")("stop4", "08:20"_t)("stop5", "08:30"_t);
+    b.connection("stop2", "stop3", 60);
+    b.connection("stop3", "stop4", 60);
+    b.data->pt_data->index();
+    b.finish();
+    b.data->build_raptor();
+    {
+        RAPTOR raptor(*b.data);
+        auto res = raptor.compute(b.sas["stop1"], b.sas["stop5"], "07:55"_t, 0,
+                                  DateTimeUtils::inf, type::RTLevel::Base, 2_min, true);
+        BOOST_CHECK_EQUAL(res.size(), 0);
+    }
+
+    b.data->dataRaptor->connections.closure_duration = 5*60;
+    b.data->build_raptor();
+    const auto* conn = b.data->dataRaptor->get_connection(*b.sps["stop2"], *b.sps["stop4"]);
+    BOOST_REQUIRE(conn);
+    BOOST_CHECK_EQUAL(conn->duration, 120);
+    BOOST_CHECK(! b.data->dataRaptor->get_connection(*b.sps["stop4"], *b.sps["stop2"]));
+    // the closure is kept in raptor only
+    BOOST_CHECK(! b.data->pt_data->get_stop_point_connection(*b.sps["stop2"], *b.sps["stop4"]));
+
+    RAPTOR raptor(*b.data);
+    auto res = raptor.compute(b.sas["stop1"], b.sas["stop5"], "07:55"_t, 0,
+                              DateTimeUtils::inf, type::RTLevel::Base, 2_min, true);
+    BOOST_REQUIRE_EQUAL(res.size(), 1);
+    BOOST_CHECK_EQUAL(res[0].items.back().arrival, "20120614T083000"_dt);
+}
@@ -36,6 +36,7 @@ www.navitia.io
 #include "routing_api_test_data.h"
 #include "tests/utils_test.h"
 #include "routing/raptor.h"
+#include "routing/isochrone.h"
 #include "georef/street_network.h"
 #include "type/data.h"
 #include "type/rt_level.h"
@@ -109,7 +110,7 @@ BOOST_AUTO_TEST_CASE(simple_journey) {
     navitia::type::EntryPoint origin(origin_type, "stop_area:stop1");
     navitia::type::EntryPoint destination(destination_type, "stop_area:stop2");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {ntest::to_posix_timestamp("20120614T021000")},
                                              true, navitia::type::AccessibiliteParams()/*false*/, forbidden,
                                              sn_worker, nt::RTLevel::Base, boost::gregorian::not_a_date_time, 2_min);
@@ -173,7 +174,7 @@ BOOST_AUTO_TEST_CASE(simple_journey_with_crow_fly) {
     origin.streetnetwork_params.max_duration = 15_min;
     destination.streetnetwork_params.max_duration = 15_min;
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                              {ntest::to_posix_timestamp("20120614T021000")},
                                              true, navitia::type::AccessibiliteParams()/*false*/,
@@ -257,7 +258,7 @@ BOOST_AUTO_TEST_CASE(journey_stay_in) {
     navitia::type::EntryPoint origin(origin_type, "bet");
     navitia::type::EntryPoint destination(destination_type, "rs");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                             {ntest::to_posix_timestamp("20120614T165300")},
                                              true, navitia::type::AccessibiliteParams(),
@@ -318,7 +319,7 @@ BOOST_AUTO_TEST_CASE(journey_stay_in_teleport) {
     navitia::type::EntryPoint origin(origin_type, "bet");
     navitia::type::EntryPoint destination(destination_type, "rs");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {ntest::to_posix_timestamp("20120614T165300")},
                                              true, navitia::type::AccessibiliteParams(),
                                              forbidden, sn_worker, nt::RTLevel::Base,
@@ -385,7 +386,7 @@ BOOST_AUTO_TEST_CASE(journey_stay_in_shortteleport) {
     navitia::type::EntryPoint origin(origin_type, "bet");
     navitia::type::EntryPoint destination(destination_type, "rs");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination, {ntest::to_posix_timestamp("20120614T165300")},
                                              true, navitia::type::AccessibiliteParams(),
                                              forbidden, sn_worker, nt::RTLevel::Base,
@@ -461,7 +462,7 @@ BOOST_AUTO_TEST_CASE(journey_departure_from_a_stay_in) {
     navitia::type::EntryPoint origin(origin_type, "start");
     navitia::type::EntryPoint destination(destination_type, "end");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                             {ntest::to_posix_timestamp("20120614T165300")},
                                              true, navitia::type::AccessibiliteParams(),
@@ -529,7 +530,7 @@ BOOST_AUTO_TEST_CASE(journey_arrival_before_a_stay_in) {
     navitia::type::EntryPoint origin(origin_type, "start");
     navitia::type::EntryPoint destination(destination_type, "end");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                              {ntest::to_posix_timestamp("20120614T165300")},
                                              true, navitia::type::AccessibiliteParams(),
@@ -586,7 +587,7 @@ BOOST_AUTO_TEST_CASE(journey_arrival_in_a_stay_in) {
     navitia::type::EntryPoint origin(origin_type, "start");
     navitia::type::EntryPoint destination(destination_type, "end");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                             {ntest::to_posix_timestamp("20120614T165300")},
                                              true, navitia::type::AccessibiliteParams(),
@@ -654,7 +655,7 @@ BOOST_AUTO_TEST_CASE(journey_arrival_before_a_stay_in_without_teleport) {
     navitia::type::EntryPoint origin(origin_type, "start");
     navitia::type::EntryPoint destination(destination_type, "end");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                              {ntest::to_posix_timestamp("20120614T165300")},
                                              true, navitia::type::AccessibiliteParams(),
@@ -701,7 +702,7 @@ BOOST_AUTO_TEST_CASE(journey_stay_in_shortteleport_counterclockwise) {
     navitia::type::EntryPoint origin(origin_type, "bet");
     navitia::type::EntryPoint destination(destination_type, "rs");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                             {ntest::to_posix_timestamp("20120614T174000")}, false,
                                              navitia::type::AccessibiliteParams(), forbidden,
@@ -760,7 +761,7 @@ BOOST_AUTO_TEST_CASE(journey_array){
     navitia::type::EntryPoint origin(origin_type, "stop_area:stop1");
     navitia::type::EntryPoint destination(destination_type, "stop_area:stop2");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
 
     //we put the time not in the right order to check that they are correctly sorted
     std::vector<uint64_t> datetimes({ntest::to_posix_timestamp("20120614T080000"), ntest::to_posix_timestamp("20120614T090000")});
@@ -800,7 +801,7 @@ template <typename speed_provider_trait>
 struct streetnetworkmode_fixture : public routing_api_data<speed_provider_trait> {
 
     pbnavitia::Response make_response() {
-        ng::StreetNetwork sn_worker(*this->b.data->geo_ref);
+        ng::StreetNetwork sn_worker(*this->b.data->geo_ref, *this->b.data->projected_stop_points);
         nr::RAPTOR raptor(*this->b.data);
         return nr::make_response(raptor, this->origin, this->destination, this->datetimes,
                                  true, navitia::type::AccessibiliteParams(),
@@ -1308,7 +1309,7 @@ BOOST_FIXTURE_TEST_CASE(bus_car_parking, streetnetworkmode_fixture<test_speed_pr
     destination.streetnetwork_params.speed_factor = speed_factor;
     datetimes = {navitia::test::to_posix_timestamp("20120614T070000")};
 
-    ng::StreetNetwork sn_worker(*this->b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*this->b.data->geo_ref, *this->b.data->projected_stop_points);
     nr::RAPTOR raptor(*this->b.data);
     auto resp = nr::make_response(raptor, this->destination, this->origin, this->datetimes, true,
                                   navitia::type::AccessibiliteParams(), this->forbidden, sn_worker,
@@ -1737,7 +1738,7 @@ BOOST_AUTO_TEST_CASE(projection_on_one_way) {
     BOOST_CHECK_EQUAL(starting_edge.vertices[ng::ProjectionData::Direction::Target], AA);
     BOOST_CHECK_EQUAL(starting_edge.vertices[ng::ProjectionData::Direction::Source], BB);
 
-    ng::StreetNetwork sn_worker(*b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
     nr::RAPTOR raptor(*b.data);
     auto resp = nr::make_response(raptor, origin, destination,
                                   {navitia::test::to_posix_timestamp("20120614T080000")},
@@ -1827,7 +1828,7 @@ BOOST_AUTO_TEST_CASE(use_crow_fly){
     BOOST_CHECK(nr::use_crow_fly(ep, &sp2, empty_sn_path, data));
     BOOST_CHECK(! nr::use_crow_fly(ep, &sp2, filled_sn_path, data));
 
-    admin->main_stop_areas.push_back(&sa2);
+    data.pt_data->admin_main_stop_areas[admin->idx].push_back(&sa2);
     BOOST_CHECK(nr::use_crow_fly(ep, &sp2, empty_sn_path, data));
     BOOST_CHECK(nr::use_crow_fly(ep, &sp2, filled_sn_path, data));
 }
@@ -1853,7 +1854,7 @@ struct isochrone_fixture {
  */
 BOOST_FIXTURE_TEST_CASE(isochrone, isochrone_fixture) {
     nr::RAPTOR raptor(*(b.data));
-    ng::StreetNetwork sn_worker(*b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
 
     navitia::type::EntryPoint ep {navitia::type::Type_e::StopPoint, "A"};
 
@@ -1887,7 +1888,7 @@ BOOST_FIXTURE_TEST_CASE(isochrone, isochrone_fixture) {
  */
 BOOST_FIXTURE_TEST_CASE(reverse_isochrone, isochrone_fixture) {
     nr::RAPTOR raptor(*(b.data));
-    ng::StreetNetwork sn_worker(*b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
 
     navitia::type::EntryPoint ep {navitia::type::Type_e::StopPoint, "B"};
 
@@ -1915,7 +1916,7 @@ BOOST_FIXTURE_TEST_CASE(reverse_isochrone, isochrone_fixture) {
  */
 BOOST_FIXTURE_TEST_CASE(isochrone_duration_limit, isochrone_fixture) {
     nr::RAPTOR raptor(*(b.data));
-    ng::StreetNetwork sn_worker(*b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
 
     navitia::type::EntryPoint ep {navitia::type::Type_e::StopPoint, "A"};
 
@@ -1937,6 +1938,47 @@ BOOST_FIXTURE_TEST_CASE(isochrone_duration_limit, isochrone_fixture) {
 }
 
 
+/**
+ * batch isochrone from A and C, each origin must get the same travel
+ * times as with a classic isochrone
+ */
+BOOST_FIXTURE_TEST_CASE(isochrone_batch, isochrone_fixture) {
+    std::vector<navitia::type::EntryPoint> origins = {
+        {navitia::type::Type_e::StopPoint, "A"},
+        {navitia::type::Type_e::StopPoint, "C"},
+        {navitia::type::Type_e::StopPoint, "unknown"}
+    };
+
+    auto result = nr::make_isochrone_batch(*b.data,
+                                           origins,
+                                           "20150615T082000"_pts,
+                                           true,
+                                           {},
+                                           {},
+                                           nt::RTLevel::Base,
+                                           2,
+                                           3 * 60 * 60);
+    BOOST_REQUIRE_EQUAL(result.size(), 3);
+
+    auto get_duration = [&](const nr::IsochroneTravelTimes& travel_times, const std::string& sp) {
+        const nr::SpIdx sp_idx(*b.data->pt_data->stop_points_map.at(sp));
+        for (const auto& item: travel_times.items) {
+            if (item.sp_idx == sp_idx) { return int(item.duration); }
+        }
+        return -1;
+    };
+    BOOST_REQUIRE_EQUAL(result[0].items.size(), 3);
+    BOOST_CHECK_EQUAL(get_duration(result[0], "A"), 0);
+    BOOST_CHECK_EQUAL(get_duration(result[0], "B"), 15 * 60);
+    BOOST_CHECK_EQUAL(get_duration(result[0], "C"), 75 * 60);
+
+    BOOST_REQUIRE_EQUAL(result[1].items.size(), 2);
+    BOOST_CHECK_EQUAL(get_duration(result[1], "C"), 0);
+    BOOST_CHECK_EQUAL(get_duration(result[1], "B"), 150 * 60);
+
+    BOOST_CHECK(result[2].items.empty());
+}
+
 //test with disruption active
 // we add 2 disruptions, and we check that the status of the journey is correct
 BOOST_AUTO_TEST_CASE(with_information_disruptions) {
@@ -1976,7 +2018,7 @@ BOOST_AUTO_TEST_CASE(with_information_disruptions) {
     navitia::type::EntryPoint origin(origin_type, "A");
     navitia::type::EntryPoint destination(destination_type, "B");
 
-    ng::StreetNetwork sn_worker(*b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                              {ntest::to_posix_timestamp("20150315T080000")},
                                              true, nt::AccessibiliteParams(),
@@ -2031,7 +2073,7 @@ BOOST_AUTO_TEST_CASE(with_disruptions_on_network) {
     navitia::type::Type_e destination_type = b.data->get_type_of_id("B");
     navitia::type::EntryPoint origin(origin_type, "A");
     navitia::type::EntryPoint destination(destination_type, "B");
-    ng::StreetNetwork sn_worker(*b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*b.data->geo_ref, *b.data->projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                             {ntest::to_posix_timestamp("20150314T080000")},
                                             true, navitia::type::AccessibiliteParams(),
@@ -2065,7 +2107,7 @@ BOOST_AUTO_TEST_CASE(journey_with_forbidden) {
     navitia::type::EntryPoint origin(origin_type, "stop_area:stop1");
     navitia::type::EntryPoint destination(destination_type, "stop_area:stop2");
 
-    ng::StreetNetwork sn_worker(*data.geo_ref);
+    ng::StreetNetwork sn_worker(*data.geo_ref, *data.projected_stop_points);
     pbnavitia::Response resp = make_response(raptor, origin, destination,
                                                 {ntest::to_posix_timestamp("20120614T021000")},
                                              true, navitia::type::AccessibiliteParams(),
@@ -2133,7 +2175,7 @@ BOOST_FIXTURE_TEST_CASE(direct_path_car, streetnetworkmode_fixture<test_speed_pr
     destination.streetnetwork_params.max_duration = seconds(900);
     destination.streetnetwork_params.speed_factor = speed_factor;
 
-    ng::StreetNetwork sn_worker(*this->b.data->geo_ref);
+    ng::StreetNetwork sn_worker(*this->b.data->geo_ref, *this->b.data->projected_stop_points);
     nr::RAPTOR raptor(*this->b.data);
     auto resp = nr::make_response(raptor, this->origin, this->destination, this->datetimes, true,
                                   navitia::type::AccessibiliteParams(), this->forbidden, sn_worker,
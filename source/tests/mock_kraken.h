@@ -77,7 +77,10 @@ struct mock_kraken {
 
 
         // Launch only one thread for the tests
-        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf));
+        threads.create_thread(std::bind(&doWork, std::ref(context), std::ref(data_manager), conf,
+                                        std::string("inproc://workers"),
+                                        std::shared_ptr<navitia::kraken::ResponseCache>(),
+                                        std::shared_ptr<navitia::kraken::Metrics>()));
 
         // Connect work threads to client threads via a queue
         do {
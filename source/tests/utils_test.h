@@ -5,6 +5,7 @@
 #include "type/response.pb.h"
 #include "routing/raptor.h"
 #include "kraken/realtime.h"
+#include "kraken/rt_batch.h"
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <set>
@@ -62,6 +63,27 @@ get_impact(const std::string& uri, const pbnavitia::Response& resp) {
     return nullptr;
 }
 
+inline transit_realtime::FeedMessage make_feed_message(uint64_t timestamp) {
+    transit_realtime::FeedMessage message;
+    message.mutable_header()->set_gtfs_realtime_version("1.0");
+    message.mutable_header()->set_timestamp(timestamp);
+    return message;
+}
+
+inline void add_trip_update(transit_realtime::FeedMessage& message, const std::string& id,
+                            const std::string& vj_uri) {
+    auto* entity = message.add_entity();
+    entity->set_id(id);
+    entity->mutable_trip_update()->mutable_trip()->set_trip_id(vj_uri);
+}
+
+// the ids of the entities of a realtime batch, in their order
+inline std::vector<std::string> entity_ids(const RtBatch& batch) {
+    std::vector<std::string> res;
+    for (const auto& update: batch.updates) { res.push_back(update.entity->id()); }
+    return res;
+}
+
 }}// namespace navitia::test
 
 inline u_int32_t operator"" _t(const char* str, size_t s) {
@@ -0,0 +1,92 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "arena.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace navitia {
+
+static thread_local Arena* current_arena = nullptr;
+
+// the memory kept between two requests
+static const size_t max_kept_size = 16 * 1024 * 1024;
+
+Arena::Arena(size_t chunk_size): chunk_size(chunk_size) {}
+
+void Arena::add_chunk(size_t size) {
+    chunks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+    offset = 0;
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+    if (! chunks.empty()) {
+        const auto& chunk = chunks.back();
+        const auto address = reinterpret_cast<uintptr_t>(chunk.data.get()) + offset;
+        const size_t padding = (alignment - address % alignment) % alignment;
+        if (offset + padding + size <= chunk.size) {
+            offset += padding + size;
+            return chunk.data.get() + offset - size;
+        }
+    }
+    // the chunks are allocated by new[], aligned for any type
+    add_chunk(std::max(chunk_size, size));
+    offset = size;
+    return chunks.back().data.get();
+}
+
+size_t Arena::capacity() const {
+    size_t res = 0;
+    for (const auto& chunk: chunks) { res += chunk.size; }
+    return res;
+}
+
+void Arena::reset() {
+    if (chunks.size() > 1 || capacity() > max_kept_size) {
+        // a single chunk big enough for the next similar request
+        const size_t size = std::min(capacity(), max_kept_size);
+        chunks.clear();
+        add_chunk(size);
+    }
+    offset = 0;
+}
+
+Arena* Arena::current() { return current_arena; }
+
+ArenaScope::ArenaScope(Arena& arena): arena(arena), previous(current_arena) {
+    current_arena = &arena;
+}
+
+ArenaScope::~ArenaScope() {
+    current_arena = previous;
+    arena.reset();
+}
+
+} // namespace navitia
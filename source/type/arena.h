@@ -0,0 +1,128 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace navitia {
+
+/**
+ * Monotonic arena for the temporaries of a request
+ *
+ * Allocating is a pointer increment, nothing is freed until reset(),
+ * that frees everything at once. The memory is kept for the next
+ * request: in a steady state a request doesn't call malloc for the
+ * containers using an ArenaAllocator.
+ */
+class Arena {
+public:
+    explicit Arena(size_t chunk_size = 64 * 1024);
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t size, size_t alignment);
+    /// invalidates everything allocated, the objects must have been destroyed
+    void reset();
+
+    size_t nb_chunks() const { return chunks.size(); }
+    size_t capacity() const;
+
+    /// the arena of the current ArenaScope of the thread, if any
+    static Arena* current();
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+    std::vector<Chunk> chunks;
+    size_t offset = 0;
+    size_t chunk_size;
+
+    void add_chunk(size_t size);
+    friend class ArenaScope;
+};
+
+/**
+ * Make an arena the current one of the thread
+ *
+ * The arena is reset at the end of the scope, nothing allocated in it
+ * must live longer than the scope.
+ */
+class ArenaScope {
+    Arena& arena;
+    Arena* previous;
+public:
+    explicit ArenaScope(Arena& arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+};
+
+/**
+ * Allocator using the current arena of the thread when the container is
+ * built, the heap if there is none
+ *
+ * The container keeps its arena. A copy uses the arena current when it
+ * is made: a copy made out of the scope, or given a null arena, is on the
+ * heap and can outlive the scope.
+ */
+template<typename T>
+struct ArenaAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    Arena* arena;
+
+    ArenaAllocator() noexcept: arena(Arena::current()) {}
+    explicit ArenaAllocator(Arena* arena) noexcept: arena(arena) {}
+    template<typename U> ArenaAllocator(const ArenaAllocator<U>& other) noexcept: arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        if (arena) { return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T))); }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+    void deallocate(T* p, size_t) noexcept {
+        if (! arena) { ::operator delete(p); }
+    }
+    ArenaAllocator select_on_container_copy_construction() const { return ArenaAllocator(); }
+};
+
+template<typename T, typename U>
+bool operator==(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.arena == rhs.arena; }
+template<typename T, typename U>
+bool operator!=(const ArenaAllocator<T>& lhs, const ArenaAllocator<U>& rhs) { return lhs.arena != rhs.arena; }
+
+} // namespace navitia
@@ -34,6 +34,9 @@ www.navitia.io
 #include <boost/archive/binary_oarchive.hpp>
 #include <boost/archive/binary_iarchive.hpp>
 #include <boost/iostreams/filtering_streambuf.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/stream.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/range/algorithm_ext/push_back.hpp>
@@ -43,6 +46,10 @@ www.navitia.io
 #include <boost/range/algorithm/find.hpp>
 #include <boost/container/container_fwd.hpp>
 #include <thread>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sstream>
+#include <exception>
 
 #include "third_party/eos_portable_archive/portable_iarchive.hpp"
 #include "third_party/eos_portable_archive/portable_oarchive.hpp"
@@ -64,15 +71,16 @@ namespace navitia { namespace type {
 
 wrong_version::~wrong_version() noexcept {}
 
-const unsigned int Data::data_version = 60; //< *INCREMENT* every time serialized data are modified
+const unsigned int Data::data_version = 64; //< *INCREMENT* every time serialized data are modified
 
 Data::Data(size_t data_identifier) :
     data_identifier(data_identifier),
     meta(std::make_unique<MetaData>()),
     pt_data(std::make_unique<PT_Data>()),
-    geo_ref(std::make_unique<navitia::georef::GeoRef>()),
+    geo_ref(std::make_shared<navitia::georef::GeoRef>()),
+    projected_stop_points(std::make_shared<navitia::georef::ProjectedStopPoints>()),
     dataRaptor(std::make_unique<navitia::routing::dataRAPTOR>()),
-    fare(std::make_unique<navitia::fare::Fare>()),
+    fare(std::make_shared<navitia::fare::Fare>()),
     find_admins(
             [&](const GeographicalCoord &c){
             return geo_ref->find_admins(c);
@@ -87,13 +95,30 @@ Data::~Data(){}
 
 bool Data::load(const std::string& filename,
         const boost::optional<std::string>& chaos_database,
-        const std::vector<std::string>& contributors) {
+        const std::vector<std::string>& contributors,
+        const Data* previous,
+        const navitia::time_duration& transfer_closure,
+        size_t nb_chaos_threads) {
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     loading = true;
+    // the disruptions of chaos are read while the data is loading, from its production period
+    std::unique_ptr<DisruptionDatabaseLoader> chaos_loader;
+    const auto start_chaos_loader = [&]() {
+        if (chaos_database) {
+            chaos_loader = std::make_unique<DisruptionDatabaseLoader>(
+                *chaos_database, meta->production_date, contributors, nb_chaos_threads);
+        }
+    };
     try {
-        std::ifstream ifs(filename.c_str(), std::ios::in | std::ios::binary);
-        ifs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-        this->load(ifs);
+        // mapped for load_sectioned, that decompresses each section from its
+        // place in the file; the data is still deserialized in the memory of
+        // each kraken, nothing of it is used in place or shared
+        boost::iostreams::mapped_file_source file(filename);
+        posix_madvise(const_cast<char*>(file.data()), file.size(), POSIX_MADV_SEQUENTIAL);
+        if (! is_sectioned(file.data(), file.size())) {
+            throw wrong_version("not a sectioned data file, it must be generated again");
+        }
+        load_sectioned(file.data(), file.size(), previous, start_chaos_loader);
         last_load_at = pt::microsec_clock::universal_time();
         last_load = true;
         loaded = true;
@@ -102,9 +127,10 @@ bool Data::load(const std::string& filename,
                        % pt_data->stop_point_connections.size()
                        % pt_data->stop_points.size()
             );
-        if (chaos_database) {
-            fill_disruption_from_database(*chaos_database, *pt_data, *meta, contributors);
+        if (chaos_loader) {
+            chaos_loader->apply(*pt_data, *meta);
         }
+        dataRaptor->connections.closure_duration = transfer_closure.total_seconds();
         build_raptor();
     } catch(const wrong_version& ex) {
         LOG4CPLUS_ERROR(logger, "Cannot load data: " << ex.what());
@@ -120,16 +146,8 @@ bool Data::load(const std::string& filename,
     return this->last_load;
 }
 
-void Data::load(std::istream& ifs) {
-    boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
-    in.push(LZ4Decompressor(2048*500),8192*500, 8192*500);
-    in.push(ifs);
-    eos::portable_iarchive ia(in);
-    ia >> *this;
-}
-
 
-void Data::save(const std::string& filename) const {
+void Data::save(const std::string& filename, bool high_compression) const {
     log4cplus::Logger logger = log4cplus::Logger::getInstance(LOG4CPLUS_TEXT("logger"));
     boost::filesystem::path p(filename);
     boost::filesystem::path dir = p.parent_path();
@@ -147,7 +165,7 @@ void Data::save(const std::string& filename) const {
     std::ofstream ofs(filename.c_str(),std::ios::out|std::ios::binary|std::ios::trunc);
     ofs.exceptions(std::ifstream::failbit | std::ifstream::badbit);
     try{
-        this->save(ofs);
+        this->save(ofs, high_compression);
     } catch(const boost::filesystem::filesystem_error &e) {
         if(e.code() == boost::system::errc::permission_denied)
             LOG4CPLUS_ERROR(logger, "Writing permission is denied for " << p);
@@ -170,12 +188,208 @@ void Data::save(const std::string& filename) const {
     }
 }
 
-void Data::save(std::ostream& ofs) const {
-    boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
-    out.push(LZ4Compressor(2048*500), 1024*500, 1024*500);
-    out.push(ofs);
-    eos::portable_oarchive oa(out);
-    oa << *this;
+// A sectioned archive is made of:
+//  - the magic,
+//  - the data version, the number of sections (uint32),
+//  - for each section, its id (uint32), its size and its hash (uint64),
+//  - the sections, each of them being a lz4 compressed portable archive.
+// The integers are little endian.
+static const char sectioned_magic[8] = {'N', 'A', 'V', 'S', 'E', 'C', 'T', '\1'};
+enum class Section: uint32_t {
+    pt_data = 0,
+    geo_ref,
+    meta,
+    fare,
+    projected_stop_points
+};
+
+// FNV-1a of the compressed section, used to find if the section of a
+// reloaded file is the same as the one of the current data
+static uint64_t section_hash(const std::string& section) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (const char c: section) {
+        hash ^= uint8_t(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template<typename T>
+static void write_le(std::ostream& os, T val) {
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        os.put(char(val & 0xFF));
+        val >>= 8;
+    }
+}
+
+template<typename T>
+static T read_le(const char*& cur, const char* end) {
+    if (size_t(end - cur) < sizeof(T)) {
+        throw navitia::exception("truncated sectioned archive");
+    }
+    T val = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) {
+        val |= T(uint8_t(cur[i])) << (8 * i);
+    }
+    cur += sizeof(T);
+    return val;
+}
+
+namespace {
+// the cross references between the sections are serialized as idx
+// while this guard lives
+struct CrossRefsAsIdx {
+    CrossRefsAsIdx() { CrossRefs::current() = CrossRefs(); CrossRefs::current().as_idx = true; }
+    ~CrossRefsAsIdx() { CrossRefs::current() = CrossRefs(); }
+};
+}
+
+static void resolve_cross_refs(CrossRefs& refs, const georef::GeoRef& geo_ref) {
+    for (auto& ref: refs.admins) {
+        for (const auto idx: ref.second) { ref.first->push_back(geo_ref.admins.at(idx)); }
+    }
+}
+
+template<typename F>
+static std::string make_section(bool high_compression, F f) {
+    std::ostringstream os;
+    {
+        boost::iostreams::filtering_streambuf<boost::iostreams::output> out;
+        out.push(LZ4ParallelCompressor(1024*1024, high_compression), 1024*500, 1024*500);
+        out.push(os);
+        eos::portable_oarchive oa(out);
+        f(oa);
+    }
+    return os.str();
+}
+
+void Data::save(std::ostream& ofs, bool high_compression) const {
+    std::vector<std::pair<Section, std::string>> sections;
+    {
+        CrossRefsAsIdx guard;
+        sections.emplace_back(Section::pt_data, make_section(high_compression, [&](eos::portable_oarchive& oa) {
+            oa << pt_data;
+        }));
+        sections.emplace_back(Section::geo_ref, make_section(high_compression, [&](eos::portable_oarchive& oa) {
+            oa << *geo_ref;
+        }));
+    }
+    sections.emplace_back(Section::projected_stop_points,
+                          make_section(high_compression, [&](eos::portable_oarchive& oa) {
+        oa << *projected_stop_points;
+    }));
+    sections.emplace_back(Section::meta, make_section(high_compression, [&](eos::portable_oarchive& oa) {
+        oa << meta << last_load_at << loaded << last_load << is_connected_to_rabbitmq
+           << is_realtime_loaded;
+    }));
+    sections.emplace_back(Section::fare, make_section(high_compression, [&](eos::portable_oarchive& oa) {
+        oa << *fare;
+    }));
+
+    ofs.write(sectioned_magic, sizeof(sectioned_magic));
+    write_le<uint32_t>(ofs, data_version);
+    write_le<uint32_t>(ofs, sections.size());
+    for (const auto& section: sections) {
+        write_le<uint32_t>(ofs, uint32_t(section.first));
+        write_le<uint64_t>(ofs, section.second.size());
+        write_le<uint64_t>(ofs, section_hash(section.second));
+    }
+    for (const auto& section: sections) {
+        ofs.write(section.second.data(), section.second.size());
+    }
+}
+
+bool Data::is_sectioned(const char* begin, size_t size) {
+    return size >= sizeof(sectioned_magic)
+        && std::equal(sectioned_magic, sectioned_magic + sizeof(sectioned_magic), begin);
+}
+
+void Data::load_sectioned(const char* begin, size_t size, const Data* previous,
+                          const std::function<void()>& on_meta) {
+    const char* const end = begin + size;
+    const char* cur = begin + sizeof(sectioned_magic);
+    const auto file_version = read_le<uint32_t>(cur, end);
+    if (file_version != data_version) {
+        unsigned int v = data_version;
+        auto msg = boost::format("Warning data version don't match with the data version of kraken %u (current version: %d)")
+            % file_version % v;
+        throw wrong_version(msg.str());
+    }
+    this->version = file_version;
+    const auto nb_sections = read_le<uint32_t>(cur, end);
+    std::vector<std::pair<Section, uint64_t>> index;
+    bool reuse_geo_ref = false;
+    for (uint32_t i = 0; i < nb_sections; ++i) {
+        const auto id = Section(read_le<uint32_t>(cur, end));
+        const auto section_size = read_le<uint64_t>(cur, end);
+        const auto hash = read_le<uint64_t>(cur, end);
+        index.emplace_back(id, section_size);
+        if (id == Section::geo_ref) {
+            // the geo_ref doesn't depend on pt_data, if it hasn't
+            // changed we keep the one of the current data
+            reuse_geo_ref = previous && previous->geo_ref_hash != 0 && previous->geo_ref_hash == hash;
+            geo_ref_hash = hash;
+        }
+    }
+    if (reuse_geo_ref) {
+        LOG4CPLUS_INFO(log4cplus::Logger::getInstance("log"), "geo_ref unchanged, it is shared with the current data");
+        geo_ref = previous->geo_ref;
+    }
+
+    // checked before starting any thread, a thread left joinable by an exception would terminate kraken
+    std::vector<const char*> section_begins;
+    for (const auto& section: index) {
+        if (uint64_t(end - cur) < section.second) {
+            throw navitia::exception("truncated sectioned archive");
+        }
+        section_begins.push_back(cur);
+        cur += section.second;
+    }
+
+    // one pool for all the sections, instead of a pool of all the cores by section
+    const auto lz4_pool = std::make_shared<lz4_detail::ThreadPool>(lz4_detail::default_nb_threads());
+    std::vector<CrossRefs> cross_refs(index.size());
+    std::vector<std::exception_ptr> errors(index.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < index.size(); ++i) {
+        const char* section_begin = section_begins[i];
+        threads.emplace_back([&, i, section_begin]() {
+            try {
+                CrossRefsAsIdx guard;
+                boost::iostreams::stream<boost::iostreams::array_source> is(section_begin, index[i].second);
+                boost::iostreams::filtering_streambuf<boost::iostreams::input> in;
+                in.push(LZ4ParallelDecompressor(lz4_pool), 8192*500, 8192*500);
+                in.push(is);
+                eos::portable_iarchive ia(in);
+                switch (index[i].first) {
+                case Section::pt_data: ia >> pt_data; break;
+                case Section::geo_ref:
+                    if (! reuse_geo_ref) { ia >> *geo_ref; }
+                    break;
+                case Section::projected_stop_points: ia >> *projected_stop_points; break;
+                case Section::meta:
+                    ia >> meta >> last_load_at >> loaded >> last_load >> is_connected_to_rabbitmq
+                       >> is_realtime_loaded;
+                    if (on_meta) { on_meta(); }
+                    break;
+                case Section::fare: ia >> *fare; break;
+                default: break; // unknown section, from a newer writer
+                }
+                cross_refs[i] = std::move(CrossRefs::current());
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread: threads) { thread.join(); }
+    for (const auto& error: errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+
+    // every section is loaded, we can resolve the cross references
+    for (auto& refs: cross_refs) {
+        resolve_cross_refs(refs, *geo_ref);
+    }
 }
 
 void Data::build_uri(){
@@ -190,7 +404,7 @@ ITERATE_NAVITIA_PT_TYPES(CLEAR_EXT_CODE)
 void Data::build_proximity_list(){
     this->pt_data->build_proximity_list();
     this->geo_ref->build_proximity_list();
-    this->geo_ref->project_stop_points(this->pt_data->stop_points);
+    *this->projected_stop_points = this->geo_ref->project_stop_points(this->pt_data->stop_points);
 }
 
 void  Data::build_administrative_regions() {
@@ -239,7 +453,7 @@ void  Data::build_administrative_regions() {
     for (const auto* sa: pt_data->stop_areas)
         for (auto admin: sa->admin_list)
             if (!admin->from_original_dataset)
-                admin->main_stop_areas.push_back(sa);
+                pt_data->admin_main_stop_areas[admin->idx].push_back(sa);
 }
 
 void Data::build_autocomplete(){
@@ -256,6 +470,14 @@ void Data::build_raptor(size_t cache_size) {
                     "Finished to build dataRaptor");
 }
 
+void Data::build_raptor(const Data& previous, size_t cache_size) {
+    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("log"),
+                    "Start to build dataRaptor from the previous data");
+    dataRaptor->load(*this->pt_data, *previous.dataRaptor, cache_size);
+    LOG4CPLUS_DEBUG(log4cplus::Logger::getInstance("log"),
+                    "Finished to build dataRaptor");
+}
+
 ValidityPattern* Data::get_similar_validity_pattern(ValidityPattern* vp) const{
     auto find_vp_predicate = [&](ValidityPattern* vp1) { return ((*vp) == (*vp1));};
     auto it = std::find_if(this->pt_data->validity_patterns.begin(),
@@ -481,7 +703,7 @@ void Data::aggregate_odt(){
     //we first store the stops in a set not to have dupplicates
     for (const auto& p: odt_stops_by_admin) {
         for (const auto& sp: p.second) {
-            p.first->odt_stop_points.push_back(sp);
+            pt_data->admin_odt_stop_points[p.first->idx].push_back(sp);
         }
     }
 }
@@ -785,10 +1007,34 @@ struct Pipe {
 // stream the source object in a binary_oarchive, and then stream it
 // in our object.  To avoid having the whole binary_oarchive in
 // memory, we construct a pipe between 2 threads.
+//
+// Only pt_data and meta are cloned: the realtime never modifies the
+// geo_ref, the projected stop points and the fare, they are shared with
+// the source, and the admins of pt_data are streamed as idx in the
+// shared geo_ref.  pt_data is still deep cloned as a whole, even when a
+// batch touches a few vehicle journeys.
 void Data::clone_from(const Data& from) {
+    // geo_ref, projections and fare are not modified by the realtime, they are shared
+    geo_ref = from.geo_ref;
+    geo_ref_hash = from.geo_ref_hash;
+    projected_stop_points = from.projected_stop_points;
+    fare = from.fare;
+    version = from.version;
+
     Pipe p;
-    std::thread write([&]() {boost::archive::binary_oarchive oa(p.out); oa << from;});
-    { boost::archive::binary_iarchive ia(p.in); ia >> *this; }
+    std::thread write([&]() {
+        CrossRefsAsIdx guard;
+        boost::archive::binary_oarchive oa(p.out);
+        oa << from.pt_data << from.meta << from.last_load_at << from.loaded << from.last_load
+           << from.is_connected_to_rabbitmq << from.is_realtime_loaded;
+    });
+    {
+        CrossRefsAsIdx guard;
+        boost::archive::binary_iarchive ia(p.in);
+        ia >> pt_data >> meta >> last_load_at >> loaded >> last_load
+           >> is_connected_to_rabbitmq >> is_realtime_loaded;
+        resolve_cross_refs(CrossRefs::current(), *geo_ref);
+    }
     write.join();
 }
 
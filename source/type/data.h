@@ -35,6 +35,7 @@ www.navitia.io
 #include <boost/format.hpp>
 #include <boost/optional.hpp>
 #include <atomic>
+#include <functional>
 #include "type/type.h"
 #include "utils/serialization_unique_ptr.h"
 #include "utils/serialization_atomic.h"
@@ -45,6 +46,7 @@ www.navitia.io
 namespace navitia {
     namespace georef {
         struct GeoRef;
+        struct ProjectedStopPoints;
         struct POI;
         struct POIType;
     }
@@ -142,13 +144,23 @@ public:
     /// public transport (PT) referential
     std::unique_ptr<PT_Data> pt_data;
 
-    std::unique_ptr<navitia::georef::GeoRef> geo_ref;
+    /// street network referential, never modified once loaded: it is
+    /// shared by the clones of the data, and by the next loaded data if
+    /// its geo_ref section has the same hash
+    std::shared_ptr<navitia::georef::GeoRef> geo_ref;
+
+    /// hash of the geo_ref section geo_ref has been loaded from, 0 if unknown
+    uint64_t geo_ref_hash = 0;
+
+    /// projections of the stop points of pt_data on geo_ref, shared by
+    /// the clones of the data
+    std::shared_ptr<navitia::georef::ProjectedStopPoints> projected_stop_points;
 
     /// precomputed data for raptor (public transport routing algorithm)
     std::unique_ptr<navitia::routing::dataRAPTOR> dataRaptor;
 
-    /// Fare data
-    std::unique_ptr<navitia::fare::Fare> fare;
+    /// Fare data, shared by the clones of the data
+    std::shared_ptr<navitia::fare::Fare> fare;
 
     // functor to find admins
     std::function<std::vector<georef::Admin*>(const GeographicalCoord&)> find_admins;
@@ -205,8 +217,8 @@ public:
 
     friend class boost::serialization::access;
     template<class Archive> void save(Archive & ar, const unsigned int) const {
-        ar & pt_data & geo_ref & meta & fare & last_load_at & loaded & last_load & is_connected_to_rabbitmq
-           & is_realtime_loaded;
+        ar & pt_data & *geo_ref & *projected_stop_points & meta & *fare & last_load_at & loaded & last_load
+           & is_connected_to_rabbitmq & is_realtime_loaded;
     }
     template<class Archive> void load(Archive & ar, const unsigned int version) {
         this->version = version;
@@ -215,18 +227,29 @@ public:
             auto msg = boost::format("Warning data version don't match with the data version of kraken %u (current version: %d)") % version % v;
             throw wrong_version(msg.str());
         }
-        ar & pt_data & geo_ref & meta & fare & last_load_at & loaded & last_load & is_connected_to_rabbitmq
-           & is_realtime_loaded;
+        ar & pt_data & *geo_ref & *projected_stop_points & meta & *fare & last_load_at & loaded & last_load
+           & is_connected_to_rabbitmq & is_realtime_loaded;
     }
     BOOST_SERIALIZATION_SPLIT_MEMBER()
 
-    /** Charge les données et effectue les initialisations nécessaires */
+    /** Charge les données et effectue les initialisations nécessaires
+     *
+     * If previous is given and its geo_ref has been loaded from the same
+     * geo_ref section, this geo_ref is shared with previous instead of
+     * being loaded again.
+     *
+     * The disruptions of chaos_database are built on nb_chaos_threads
+     * threads, along with the loading of the data.
+     */
     bool load(const std::string & filename,
             const boost::optional<std::string>& chaos_database = {},
-            const std::vector<std::string>& contributors = {});
+            const std::vector<std::string>& contributors = {},
+            const Data* previous = nullptr,
+            const navitia::time_duration& transfer_closure = navitia::seconds(0),
+            size_t nb_chaos_threads = 1);
 
-    /** Sauvegarde les données */
-    void save(const std::string & filename) const;
+    /** Sauvegarde les données, en LZ4HC si high_compression */
+    void save(const std::string & filename, bool high_compression = false) const;
 
     /** Construit l'indexe ExternelCode */
     void build_uri();
@@ -241,6 +264,9 @@ public:
     void build_administrative_regions();
     /** Construit les données raptor */
     void build_raptor(size_t cache_size = 10);
+    /** Construit les données raptor en réutilisant celles de previous,
+     * dont cette Data est un clone modifié par le temps réel */
+    void build_raptor(const Data& previous, size_t cache_size = 10);
 
     void build_associated_calendar();
 
@@ -258,17 +284,29 @@ public:
 
     Type_e get_type_of_id(const std::string & id) const;
 
-    /** Charge les données binaires compressées en LZ4
+    /** Sauvegarde les données en binaire compressé avec LZ4
       *
-      * La compression LZ4 est extrèmement rapide mais moyennement performante
-      * Le but est que la lecture du fichier compression soit aussi rapide que sans compression
+      * The archive is sectioned: each of pt_data, geo_ref, the stop point
+      * projections, meta and fare is compressed independently, so they
+      * can be loaded in parallel.
+      * The chunks of each section are also (de)compressed in parallel.
       */
-    void load(std::istream& ifs);
-
-    /** Sauvegarde les données en binaire compressé avec LZ4*/
-    void save(std::ostream& ifs) const;
-
-    // Deep clone from the given Data.
+    void save(std::ostream& ifs, bool high_compression = false) const;
+
+    /** Load a sectioned archive, the sections being decoded in parallel
+     *
+     * The geo_ref of previous is reused if it has the same hash.
+     * on_meta is called as soon as the meta is decoded, while the other
+     * sections are still loading.
+     */
+    void load_sectioned(const char* begin, size_t size, const Data* previous = nullptr,
+                        const std::function<void()>& on_meta = {});
+
+    /** Is the buffer a sectioned archive, or a legacy one? */
+    static bool is_sectioned(const char* begin, size_t size);
+
+    // Clone from the given Data: pt_data and meta are deep copied, geo_ref,
+    // the stop point projections and fare are shared.
     void clone_from(const Data&);
 private:
     /** Get similar validitypattern **/
@@ -0,0 +1,221 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "memory_report.h"
+#include "type/data.h"
+#include "type/pt_data.h"
+#include "type/message.h"
+#include "georef/georef.h"
+#include "georef/adminref.h"
+#include "routing/dataraptor.h"
+#include <boost/format.hpp>
+#include <map>
+#include <ostream>
+#include <type_traits>
+#include <unordered_map>
+
+namespace navitia { namespace type {
+
+// malloc header and alignment of each allocated object
+static const size_t alloc_overhead = 2 * sizeof(void*);
+
+static size_t bytes(const std::string& str) {
+    // short strings are stored inline
+    return str.capacity() > 15 ? str.capacity() + 1 + alloc_overhead : 0;
+}
+
+template<typename T>
+static size_t bytes(const std::vector<T>& vect) {
+    return vect.capacity() * sizeof(T);
+}
+
+template<typename K, typename V>
+static size_t bytes(const std::map<K, V>& map) {
+    // a red black tree node has 3 pointers and a color
+    return map.size() * (sizeof(typename std::map<K, V>::value_type) + 4 * sizeof(void*) + alloc_overhead);
+}
+
+template<typename K, typename V>
+static size_t bytes(const std::unordered_map<K, V>& map) {
+    return map.bucket_count() * sizeof(void*)
+        + map.size() * (sizeof(typename std::unordered_map<K, V>::value_type) + 2 * sizeof(void*) + alloc_overhead);
+}
+
+template<typename Map>
+static size_t keys_bytes(const Map& map) {
+    size_t res = 0;
+    for (const auto& elt: map) { res += bytes(elt.first); }
+    return res;
+}
+
+template<typename T>
+static size_t name_bytes(const T& obj, std::true_type) { return bytes(obj.name); }
+template<typename T>
+static size_t name_bytes(const T&, std::false_type) { return 0; }
+
+template<typename T>
+static size_t objects_bytes(const std::vector<T*>& objects) {
+    size_t res = bytes(objects);
+    for (const auto* obj: objects) {
+        res += sizeof(T) + alloc_overhead + bytes(obj->uri) + name_bytes(*obj, std::is_base_of<Nameable, T>());
+    }
+    return res;
+}
+
+template<typename T>
+static size_t autocomplete_bytes(const autocomplete::Autocomplete<T>& autocomplete) {
+    size_t res = bytes(autocomplete.word_quality_list);
+    for (const auto* dictionnary: {&autocomplete.word_dictionnary, &autocomplete.pattern_dictionnary}) {
+        res += bytes(*dictionnary);
+        for (const auto& elt: *dictionnary) {
+            res += bytes(elt.first) + bytes(elt.second);
+        }
+    }
+    return res;
+}
+
+static void pt_data_report(MemoryReport& report, const PT_Data& pt_data) {
+#define ADD_PT_COLLECTION(type_name, collection_name) \
+    report.add("pt_data." #collection_name, objects_bytes(pt_data.collection_name) \
+               + bytes(pt_data.collection_name##_map) + keys_bytes(pt_data.collection_name##_map));
+    ITERATE_NAVITIA_PT_TYPES(ADD_PT_COLLECTION)
+#undef ADD_PT_COLLECTION
+
+    size_t stop_times = 0;
+    for (const auto* vj: pt_data.vehicle_journeys) {
+        stop_times += bytes(vj->stop_time_list) + bytes(vj->shapes_from_prev);
+    }
+    report.add("pt_data.stop_times", stop_times);
+
+    report.add("pt_data.autocomplete",
+               autocomplete_bytes(pt_data.stop_area_autocomplete)
+               + autocomplete_bytes(pt_data.stop_point_autocomplete)
+               + autocomplete_bytes(pt_data.line_autocomplete)
+               + autocomplete_bytes(pt_data.network_autocomplete)
+               + autocomplete_bytes(pt_data.mode_autocomplete)
+               + autocomplete_bytes(pt_data.route_autocomplete));
+    report.add("pt_data.proximity_lists",
+               bytes(pt_data.stop_area_proximity_list.items) + bytes(pt_data.stop_point_proximity_list.items));
+
+    size_t impacts = bytes(pt_data.disruption_holder.get_weak_impacts());
+    for (const auto& weak_impact: pt_data.disruption_holder.get_weak_impacts()) {
+        const auto impact = weak_impact.lock();
+        if (! impact) { continue; }
+        impacts += sizeof(disruption::Impact) + alloc_overhead + bytes(impact->uri) + bytes(impact->application_periods)
+            + bytes(impact->informed_entities) + bytes(impact->messages);
+        for (const auto& message: impact->messages) { impacts += bytes(message.text); }
+    }
+    impacts += pt_data.disruption_holder.nb_disruptions() * (sizeof(disruption::Disruption) + alloc_overhead);
+    report.add("pt_data.impacts", impacts);
+}
+
+static void geo_ref_report(MemoryReport& report, const georef::GeoRef& geo_ref) {
+    // vecS adjacency list: a vector of out edges per vertex, the edge
+    // properties being allocated one by one
+    const auto& graph = geo_ref.graph;
+    report.add("geo_ref.graph",
+               boost::num_vertices(graph) * (sizeof(georef::Vertex) + sizeof(std::vector<size_t>))
+               + boost::num_edges(graph) * (sizeof(georef::Edge) + 2 * sizeof(void*) + alloc_overhead));
+
+    size_t ways = objects_bytes(geo_ref.ways) + bytes(geo_ref.way_map) + keys_bytes(geo_ref.way_map);
+    for (const auto* way: geo_ref.ways) {
+        ways += bytes(way->admin_list) + bytes(way->house_number_left)
+            + bytes(way->house_number_right) + bytes(way->edges);
+    }
+    report.add("geo_ref.ways", ways);
+
+    size_t pois = objects_bytes(geo_ref.pois) + bytes(geo_ref.poi_map) + keys_bytes(geo_ref.poi_map);
+    for (const auto* poi: geo_ref.pois) {
+        pois += bytes(poi->admin_list) + bytes(poi->properties) + bytes(poi->label);
+    }
+    report.add("geo_ref.pois", pois);
+    report.add("geo_ref.admins", objects_bytes(geo_ref.admins));
+
+    report.add("geo_ref.fl_admin", autocomplete_bytes(geo_ref.fl_admin));
+    report.add("geo_ref.fl_way", autocomplete_bytes(geo_ref.fl_way));
+    report.add("geo_ref.fl_poi", autocomplete_bytes(geo_ref.fl_poi));
+    report.add("geo_ref.pl", bytes(geo_ref.pl.items));
+    report.add("geo_ref.poi_proximity_list", bytes(geo_ref.poi_proximity_list.items));
+}
+
+static void raptor_report(MemoryReport& report, const routing::dataRAPTOR& raptor) {
+    const auto& connections = raptor.connections;
+    report.add("raptor.connections",
+               bytes(connections.forward_connections.offsets) + bytes(connections.forward_connections.connections)
+               + bytes(connections.backward_connections.offsets) + bytes(connections.backward_connections.connections));
+    report.add("raptor.jpps", raptor.jpps_from_sp.memory_usage() + raptor.jpps_from_jp.memory_usage());
+
+    size_t jps = bytes(raptor.jp_container.get_jps_values()) + bytes(raptor.jp_container.get_jpps_values());
+    for (const auto& jp: raptor.jp_container.get_jps_values()) {
+        jps += bytes(jp.jpps) + bytes(jp.discrete_vjs) + bytes(jp.freq_vjs);
+    }
+    report.add("raptor.journey_patterns", jps);
+
+    size_t validity_patterns = 0;
+    for (const auto rt_level: {RTLevel::Base, RTLevel::Adapted, RTLevel::RealTime}) {
+        const auto& bitsets = raptor.jp_validity_patterns[rt_level];
+        validity_patterns += bytes(bitsets);
+        for (const auto& bitset: bitsets) {
+            validity_patterns += bitset.num_blocks() * sizeof(boost::dynamic_bitset<>::block_type);
+        }
+    }
+    report.add("raptor.jp_validity_patterns", validity_patterns);
+
+    report.add("raptor.next_stop_times", raptor.next_stop_time_data.memory_usage());
+    if (raptor.cached_next_st_manager) {
+        report.add("raptor.next_stop_time_caches", raptor.cached_next_st_manager->memory_usage());
+    }
+}
+
+size_t MemoryReport::total() const {
+    size_t res = 0;
+    for (const auto& component: components) { res += component.second; }
+    return res;
+}
+
+std::ostream& operator<<(std::ostream& os, const MemoryReport& report) {
+    for (const auto& component: report.components) {
+        os << boost::format("%-35s %10.1f MB\n") % component.first % (component.second / 1e6);
+    }
+    return os << boost::format("%-35s %10.1f MB\n") % "total" % (report.total() / 1e6);
+}
+
+MemoryReport memory_report(const Data& data) {
+    MemoryReport report;
+    if (data.pt_data) { pt_data_report(report, *data.pt_data); }
+    if (data.geo_ref) { geo_ref_report(report, *data.geo_ref); }
+    if (data.projected_stop_points) {
+        report.add("projected_stop_points", bytes(data.projected_stop_points->projections));
+    }
+    if (data.dataRaptor) { raptor_report(report, *data.dataRaptor); }
+    return report;
+}
+
+}} // namespace navitia::type
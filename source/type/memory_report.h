@@ -0,0 +1,61 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace navitia { namespace type {
+
+class Data;
+
+/**
+ * Estimated memory used by the components of a Data
+ *
+ * The sizes are deep: the containers are counted by their capacity and
+ * the allocation overheads are approximated. It tells what to shrink,
+ * it's not an exact accounting.
+ */
+struct MemoryReport {
+    std::vector<std::pair<std::string, size_t>> components;
+
+    void add(const std::string& component, size_t bytes) { components.emplace_back(component, bytes); }
+    size_t total() const;
+};
+
+/// a line per component, in MB
+std::ostream& operator<<(std::ostream&, const MemoryReport&);
+
+MemoryReport memory_report(const Data&);
+
+}} // namespace navitia::type
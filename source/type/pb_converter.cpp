@@ -43,6 +43,7 @@ www.navitia.io
 #include "time_tables/thermometer.h"
 #include "routing/dataraptor.h"
 #include "ptreferential/ptreferential.h"
+#include "type/tracing.h"
 
 
 namespace gd = boost::gregorian;
@@ -1755,9 +1756,13 @@ void PbCreator::fill_pb_error(const pbnavitia::Error::error_id id, const std::st
 }
 
 pbnavitia::Response PbCreator::get_response(){
+    tracing::Span span("pb_creator.get_response");
     Filler(0, DumpMessage::No, *this).fill_pb_object(contributors, response.mutable_feed_publishers());
     Filler(0, DumpMessage::No, *this).fill_pb_object(impacts, response.mutable_impacts());
-    return std::move(response);
+    // protobuf messages had no move constructor before 3.4, swap is O(1)
+    pbnavitia::Response res;
+    res.Swap(&response);
+    return res;
 }
 
 void PbCreator::fill_additional_informations(google::protobuf::RepeatedField<int>* infos,
@@ -35,6 +35,7 @@ www.navitia.io
 #include "type/pt_data.h"
 #include "vptranslator/vptranslator.h"
 #include "ptreferential/ptreferential.h"
+#include "type/arena.h"
 
 namespace pt = boost::posix_time;
 namespace nt = navitia::type;
@@ -157,14 +158,18 @@ inline pbnavitia::NavitiaType get_embedded_type(const nt::MetaVehicleJourney*) {
 
 
 struct PbCreator {
-    std::set<const nt::Contributor*> contributors;
-    std::set<boost::shared_ptr<type::disruption::Impact>> impacts;
+    // temporaries of the request, in its arena if any
+    template<typename T> using ArenaSet = std::set<T, std::less<T>, ArenaAllocator<T>>;
+    ArenaSet<const nt::Contributor*> contributors;
+    ArenaSet<boost::shared_ptr<type::disruption::Impact>> impacts;
     const nt::Data& data;
     pt::ptime now;
     pt::time_period action_period;
     // Raptor api
     size_t nb_sections = 0;
-    std::map<std::pair<pbnavitia::Journey*, size_t>, std::string> routing_section_map;
+    std::map<std::pair<pbnavitia::Journey*, size_t>, std::string,
+             std::less<std::pair<pbnavitia::Journey*, size_t>>,
+             ArenaAllocator<std::pair<const std::pair<pbnavitia::Journey*, size_t>, std::string>>> routing_section_map;
     pbnavitia::Ticket* unknown_ticket = nullptr; //we want only one unknown ticket
 
     PbCreator(const nt::Data& data, const pt::ptime  now, const pt::time_period action_period):
@@ -291,22 +296,22 @@ private:
             }
         }
 
-        template<typename Nav, typename Pb>
-        void fill_pb_object(const std::set<Nav>& nav_list,
+        template<typename Nav, typename Cmp, typename Alloc, typename Pb>
+        void fill_pb_object(const std::set<Nav, Cmp, Alloc>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto& nav_obj: nav_list) {
                 fill_pb_object(&nav_obj, pb_list->Add());
             }
         }
-        template<typename Nav, typename Pb>
-        void fill_pb_object(const std::set<Nav*>& nav_list,
+        template<typename Nav, typename Cmp, typename Alloc, typename Pb>
+        void fill_pb_object(const std::set<Nav*, Cmp, Alloc>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto* nav_obj: nav_list) {
                 fill_pb_object(nav_obj, pb_list->Add());
             }
         }
-        template<typename Nav, typename Pb>
-        void fill_pb_object(const std::set<boost::shared_ptr<Nav>>& nav_list,
+        template<typename Nav, typename Cmp, typename Alloc, typename Pb>
+        void fill_pb_object(const std::set<boost::shared_ptr<Nav>, Cmp, Alloc>& nav_list,
                             ::google::protobuf::RepeatedPtrField<Pb>* pb_list) {
             for (auto& nav_obj: nav_list) {
                 fill_pb_object(nav_obj.get(), pb_list->Add());
@@ -160,6 +160,24 @@ void PT_Data::build_proximity_list() {
     this->stop_point_proximity_list.build();
 }
 
+template<typename T>
+static const std::vector<const T*>& find_by_admin(const std::map<idx_t, std::vector<const T*>>& map,
+                                                  const georef::Admin& admin) {
+    static const std::vector<const T*> empty;
+    const auto search = map.find(admin.idx);
+    return search == map.end() ? empty : search->second;
+}
+
+const std::vector<const StopArea*>&
+PT_Data::get_main_stop_areas(const georef::Admin& admin) const {
+    return find_by_admin(admin_main_stop_areas, admin);
+}
+
+const std::vector<const StopPoint*>&
+PT_Data::get_odt_stop_points(const georef::Admin& admin) const {
+    return find_by_admin(admin_odt_stop_points, admin);
+}
+
 void PT_Data::build_admins_stop_areas(){
     for(navitia::type::StopPoint* stop_point : this->stop_points){
         if(!stop_point->stop_area){
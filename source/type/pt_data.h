@@ -100,6 +100,12 @@ struct PT_Data : boost::noncopyable{
     // timezone manager
     TimeZoneManager tz_manager;
 
+    // main stop areas and odt stop points of the admins, by admin idx.
+    // They are not in the admins as the geo_ref is shared between the
+    // data generations and must not point to their pt objects.
+    std::map<idx_t, std::vector<const StopArea*>> admin_main_stop_areas;
+    std::map<idx_t, std::vector<const StopPoint*>> admin_odt_stop_points;
+
     template<class Archive> void serialize(Archive & ar, const unsigned int) {
         ar
         #define SERIALIZE_ELEMENTS(type_name, collection_name) & collection_name & collection_name##_map
@@ -114,9 +120,14 @@ struct PT_Data : boost::noncopyable{
                 & comments
                 & codes
                 & headsign_handler
-                & tz_manager;
+                & tz_manager
+                & admin_main_stop_areas
+                & admin_odt_stop_points;
     }
 
+    const std::vector<const StopArea*>& get_main_stop_areas(const georef::Admin&) const;
+    const std::vector<const StopPoint*>& get_odt_stop_points(const georef::Admin&) const;
+
     /** Initialise tous les indexes
       *
       * Les données doivent bien évidemment avoir été initialisés
@@ -0,0 +1,95 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include "type/type_interfaces.h"
+#include <boost/mpl/bool.hpp>
+#include <vector>
+
+namespace navitia { namespace georef {
+struct Admin;
+}}
+
+namespace navitia { namespace type {
+
+/**
+ * In a sectioned archive, pt_data and geo_ref are in different
+ * sections, decoded in parallel, and a cloned pt_data shares the
+ * geo_ref of its source. The pointers from pt_data to geo_ref (the
+ * cross references) are then serialized as idx, and resolved once the
+ * geo_ref is loaded.
+ */
+struct CrossRefs {
+    template<typename T>
+    using Pending = std::vector<std::pair<std::vector<T*>*, std::vector<idx_t>>>;
+
+    // enabled for the current thread
+    bool as_idx = false;
+    Pending<georef::Admin> admins;
+
+    void add(std::vector<georef::Admin*>& v, std::vector<idx_t> idx) {
+        admins.emplace_back(&v, std::move(idx));
+    }
+
+    static CrossRefs& current() {
+        static thread_local CrossRefs cross_refs;
+        return cross_refs;
+    }
+};
+
+template<class Archive, typename T>
+void serialize_cross_ref(Archive& ar, std::vector<T*>& v, boost::mpl::true_) {
+    std::vector<idx_t> idx;
+    idx.reserve(v.size());
+    for (const auto* o: v) { idx.push_back(o->idx); }
+    const auto& const_idx = idx;
+    ar & const_idx;
+}
+
+template<class Archive, typename T>
+void serialize_cross_ref(Archive& ar, std::vector<T*>& v, boost::mpl::false_) {
+    std::vector<idx_t> idx;
+    ar & idx;
+    v.clear();
+    CrossRefs::current().add(v, std::move(idx));
+}
+
+// to be used for a vector of pointers to objects in another section
+template<class Archive, typename T>
+void serialize_cross_ref(Archive& ar, std::vector<T*>& v) {
+    if (! CrossRefs::current().as_idx) {
+        ar & v;
+        return;
+    }
+    serialize_cross_ref(ar, v, typename Archive::is_saving());
+}
+
+}} // namespace navitia::type
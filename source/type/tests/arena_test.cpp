@@ -0,0 +1,113 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE arena_test
+
+#include "type/arena.h"
+#include <boost/test/unit_test.hpp>
+#include <boost/container/flat_map.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+using navitia::Arena;
+using navitia::ArenaScope;
+using navitia::ArenaAllocator;
+
+BOOST_AUTO_TEST_CASE(arena_alignment_test) {
+    Arena arena(256);
+    for (size_t align: {1, 2, 4, 8, 16, 64}) {
+        arena.allocate(3, 1);
+        auto* p = arena.allocate(5, align);
+        BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(p) % align, 0);
+    }
+    // bigger than a chunk
+    auto* big = arena.allocate(1000, 8);
+    BOOST_CHECK(big != nullptr);
+    BOOST_CHECK(arena.capacity() >= 1000);
+}
+
+BOOST_AUTO_TEST_CASE(arena_reset_reuses_memory_test) {
+    Arena arena(128);
+    for (int i = 0; i < 10; ++i) { arena.allocate(100, 8); }
+    BOOST_CHECK(arena.nb_chunks() > 1);
+    const auto capacity = arena.capacity();
+    arena.reset();
+    // the chunks are merged in one, big enough for the same request
+    BOOST_CHECK_EQUAL(arena.nb_chunks(), 1);
+    BOOST_CHECK(arena.capacity() >= capacity);
+    for (int i = 0; i < 10; ++i) { arena.allocate(100, 8); }
+    BOOST_CHECK_EQUAL(arena.nb_chunks(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(allocator_without_scope_test) {
+    BOOST_CHECK(Arena::current() == nullptr);
+    std::vector<int, ArenaAllocator<int>> v;
+    BOOST_CHECK(v.get_allocator().arena == nullptr);
+    for (int i = 0; i < 1000; ++i) { v.push_back(i); }
+    BOOST_CHECK_EQUAL(v[999], 999);
+}
+
+BOOST_AUTO_TEST_CASE(allocator_in_scope_test) {
+    Arena arena;
+    using Map = boost::container::flat_map<int, std::string, std::less<int>,
+                                           ArenaAllocator<std::pair<int, std::string>>>;
+    Map escaped;
+    {
+        ArenaScope scope(arena);
+        BOOST_CHECK(Arena::current() == &arena);
+        Map m;
+        for (int i = 0; i < 100; ++i) { m[i] = "a long enough string to be on the heap " + std::to_string(i); }
+        BOOST_CHECK(m.get_allocator().arena == &arena);
+        BOOST_CHECK(arena.capacity() > 0);
+
+        // a copy on the heap outlives the scope
+        escaped = Map(m, ArenaAllocator<std::pair<int, std::string>>(nullptr));
+    }
+    BOOST_CHECK(Arena::current() == nullptr);
+    BOOST_CHECK(escaped.get_allocator().arena == nullptr);
+    BOOST_REQUIRE_EQUAL(escaped.size(), 100);
+    BOOST_CHECK_EQUAL(escaped[42], "a long enough string to be on the heap 42");
+}
+
+BOOST_AUTO_TEST_CASE(nested_scope_test) {
+    Arena outer, inner;
+    ArenaScope outer_scope(outer);
+    {
+        ArenaScope inner_scope(inner);
+        BOOST_CHECK(Arena::current() == &inner);
+    }
+    BOOST_CHECK(Arena::current() == &outer);
+    std::map<int, int, std::less<int>, ArenaAllocator<std::pair<const int, int>>> m;
+    m[1] = 2;
+    BOOST_CHECK(m.get_allocator().arena == &outer);
+}
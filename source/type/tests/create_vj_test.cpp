@@ -39,6 +39,7 @@ www.navitia.io
 #include "type/comment_container.h"
 #include <memory>
 #include <boost/archive/text_oarchive.hpp>
+#include <boost/make_shared.hpp>
 #include <string>
 #include <type_traits>
 
@@ -95,3 +96,35 @@ BOOST_AUTO_TEST_CASE(create_vj_test) {
     BOOST_CHECK_EQUAL(rt_vj->adapted_validity_pattern()->days, year("0000000" "0000000"));
     BOOST_CHECK_EQUAL(rt_vj->rt_validity_pattern()->days, year("0000000" "0000110"));
 }
+
+BOOST_AUTO_TEST_CASE(stop_time_shape_from_prev) {
+    namespace nt = navitia::type;
+
+    ed::builder b("20120614");
+    auto* vj = b.vj("A")("stop1", 8000, 8000)("stop2", 8100, 8100)("stop3", 8200, 8200).make();
+    auto shape = boost::make_shared<nt::LineString>();
+    shape->push_back({1., 1.});
+    shape->push_back({2., 2.});
+    vj->set_shape_from_prev(2, shape);
+
+    BOOST_CHECK(! vj->stop_time_list.at(0).shape_from_prev());
+    BOOST_CHECK(! vj->stop_time_list.at(1).shape_from_prev());
+    BOOST_CHECK_EQUAL(vj->stop_time_list.at(2).shape_from_prev(), shape);
+
+    vj->set_shape_from_prev(1, shape);
+    BOOST_CHECK_EQUAL(vj->shapes_from_prev.size(), 2);
+    BOOST_CHECK_EQUAL(vj->shapes_from_prev.front().first, 1);
+    vj->set_shape_from_prev(1, nullptr);
+    BOOST_CHECK(! vj->stop_time_list.at(1).shape_from_prev());
+    BOOST_CHECK_EQUAL(vj->shapes_from_prev.size(), 1);
+
+    // the properties are packed in a byte
+    auto& st = vj->stop_time_list.at(0);
+    st.set_odt(true);
+    st.set_pick_up_allowed(false);
+    BOOST_CHECK(st.odt());
+    BOOST_CHECK(! st.pick_up_allowed());
+    BOOST_CHECK(st.drop_off_allowed());
+    st.set_odt(false);
+    BOOST_CHECK(! st.odt());
+}
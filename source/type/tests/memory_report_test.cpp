@@ -0,0 +1,88 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_memory_report
+#include <boost/test/unit_test.hpp>
+#include "type/memory_report.h"
+#include "type/data.h"
+#include "type/pt_data.h"
+#include "ed/build_helper.h"
+#include "tests/utils_test.h"
+
+#include <sstream>
+
+using namespace navitia::type;
+
+static size_t component(const MemoryReport& report, const std::string& name) {
+    for (const auto& c: report.components) {
+        if (c.first == name) { return c.second; }
+    }
+    BOOST_FAIL("no component " + name);
+    return 0;
+}
+
+static MemoryReport report_with_vjs(int nb_vjs) {
+    ed::builder b("20120614");
+    for (int i = 0; i < nb_vjs; ++i) {
+        b.vj("A")("stop1", 8000 + i * 60, 8050 + i * 60)("stop2", 8100 + i * 60, 8150 + i * 60);
+    }
+    b.finish();
+    b.data->pt_data->index();
+    b.data->build_raptor();
+    return memory_report(*b.data);
+}
+
+BOOST_AUTO_TEST_CASE(memory_report_components) {
+    const auto report = report_with_vjs(10);
+
+    BOOST_CHECK_GT(component(report, "pt_data.vehicle_journeys"), 0);
+    BOOST_CHECK_GE(component(report, "pt_data.stop_times"), 10 * 2 * sizeof(StopTime));
+    BOOST_CHECK_GT(component(report, "raptor.next_stop_times"), 0);
+    BOOST_CHECK_GT(component(report, "raptor.jpps"), 0);
+    component(report, "geo_ref.graph");
+
+    size_t total = 0;
+    for (const auto& c: report.components) { total += c.second; }
+    BOOST_CHECK_EQUAL(report.total(), total);
+
+    std::stringstream ss;
+    ss << report;
+    BOOST_CHECK_NE(ss.str().find("pt_data.stop_times"), std::string::npos);
+    BOOST_CHECK_NE(ss.str().find("total"), std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(memory_report_grows_with_the_data) {
+    const auto small = report_with_vjs(10);
+    const auto big = report_with_vjs(100);
+    BOOST_CHECK_GT(component(big, "pt_data.stop_times"), component(small, "pt_data.stop_times"));
+    BOOST_CHECK_GT(component(big, "raptor.next_stop_times"), component(small, "raptor.next_stop_times"));
+    BOOST_CHECK_GT(big.total(), small.total());
+}
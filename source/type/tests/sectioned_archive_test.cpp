@@ -0,0 +1,172 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE test_sectioned_archive
+#include <boost/test/unit_test.hpp>
+#include "type/data.h"
+#include "type/pt_data.h"
+#include "georef/georef.h"
+#include "ed/build_helper.h"
+#include "tests/utils_test.h"
+
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <sstream>
+
+using namespace navitia::type;
+
+template<typename T>
+static const T* find_by_uri(const std::vector<T*>& objects, const std::string& uri) {
+    for (const auto* o: objects) {
+        if (o->uri == uri) { return o; }
+    }
+    return nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(sectioned_archive_round_trip) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.finish();
+    b.data->pt_data->index();
+
+    // cross references between pt_data and geo_ref
+    auto* admin = new navitia::georef::Admin(8);
+    admin->idx = 0;
+    admin->uri = "admin:1";
+    b.data->geo_ref->admins.push_back(admin);
+    b.sps["stop1"]->admin_list.push_back(admin);
+    b.sas["stop1"]->admin_list.push_back(admin);
+
+    std::stringstream ss;
+    b.data->save(ss);
+    const std::string buf = ss.str();
+    BOOST_REQUIRE(Data::is_sectioned(buf.data(), buf.size()));
+
+    Data data;
+    data.load_sectioned(buf.data(), buf.size());
+    BOOST_CHECK_EQUAL(data.pt_data->stop_points.size(), b.data->pt_data->stop_points.size());
+    BOOST_CHECK_EQUAL(data.pt_data->vehicle_journeys.size(), b.data->pt_data->vehicle_journeys.size());
+    BOOST_REQUIRE_EQUAL(data.geo_ref->admins.size(), 1);
+    const auto* loaded_admin = data.geo_ref->admins[0];
+    BOOST_CHECK_EQUAL(loaded_admin->uri, "admin:1");
+
+    const auto* sp = find_by_uri(data.pt_data->stop_points, b.sps["stop1"]->uri);
+    BOOST_REQUIRE(sp);
+    BOOST_REQUIRE_EQUAL(sp->admin_list.size(), 1);
+    BOOST_CHECK_EQUAL(sp->admin_list[0], loaded_admin);
+    const auto* sa = find_by_uri(data.pt_data->stop_areas, b.sas["stop1"]->uri);
+    BOOST_REQUIRE(sa);
+    BOOST_REQUIRE_EQUAL(sa->admin_list.size(), 1);
+    BOOST_CHECK_EQUAL(sa->admin_list[0], loaded_admin);
+}
+
+BOOST_AUTO_TEST_CASE(unsectioned_file_is_rejected) {
+    const std::string buf = "not a sectioned archive";
+    BOOST_CHECK(! Data::is_sectioned(buf.data(), buf.size()));
+    const auto path = (boost::filesystem::temp_directory_path()
+                       / boost::filesystem::unique_path("data_%%%%-%%%%.nav.lz4")).string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << buf;
+    }
+    Data data;
+    BOOST_CHECK(! data.load(path));
+    BOOST_CHECK(! data.loaded);
+    boost::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(clone_shares_geo_ref) {
+    ed::builder b("20120614");
+    b.vj("A")("stop1", 8000, 8050)("stop2", 8100, 8150);
+    b.finish();
+    b.data->pt_data->index();
+    auto* admin = new navitia::georef::Admin(8);
+    admin->idx = 0;
+    admin->uri = "admin:1";
+    b.data->geo_ref->admins.push_back(admin);
+    b.sps["stop1"]->admin_list.push_back(admin);
+
+    Data clone;
+    clone.clone_from(*b.data);
+    BOOST_CHECK_EQUAL(clone.geo_ref, b.data->geo_ref);
+    BOOST_CHECK_EQUAL(clone.fare, b.data->fare);
+
+    const auto* sp = find_by_uri(clone.pt_data->stop_points, b.sps["stop1"]->uri);
+    BOOST_REQUIRE(sp);
+    BOOST_CHECK_NE(sp, b.sps["stop1"]);
+    BOOST_REQUIRE_EQUAL(sp->admin_list.size(), 1);
+    BOOST_CHECK_EQUAL(sp->admin_list[0], admin);
+}
+
+static std::string save_with_vjs(int nb_vjs, int nb_admins) {
+    ed::builder b("20120614");
+    for (int i = 0; i < nb_vjs; ++i) {
+        b.vj("A")("stop1", 8000 + i * 1000, 8050 + i * 1000)("stop2", 8100 + i * 1000, 8150 + i * 1000);
+    }
+    b.finish();
+    b.data->pt_data->index();
+    for (int i = 0; i < nb_admins; ++i) {
+        auto* admin = new navitia::georef::Admin(8);
+        admin->idx = i;
+        admin->uri = "admin:" + std::to_string(i);
+        b.data->geo_ref->admins.push_back(admin);
+    }
+    b.sps["stop1"]->admin_list.push_back(b.data->geo_ref->admins.front());
+    std::stringstream ss;
+    b.data->save(ss);
+    return ss.str();
+}
+
+BOOST_AUTO_TEST_CASE(reload_shares_unchanged_geo_ref) {
+    const std::string buf = save_with_vjs(1, 1);
+    Data current;
+    current.load_sectioned(buf.data(), buf.size());
+    BOOST_CHECK_NE(current.geo_ref_hash, 0);
+
+    // only the timetable has changed, the geo_ref is reused
+    const std::string buf2 = save_with_vjs(2, 1);
+    Data reloaded;
+    reloaded.load_sectioned(buf2.data(), buf2.size(), &current);
+    BOOST_CHECK_EQUAL(reloaded.geo_ref, current.geo_ref);
+    BOOST_CHECK_EQUAL(reloaded.geo_ref_hash, current.geo_ref_hash);
+    BOOST_CHECK_EQUAL(reloaded.pt_data->vehicle_journeys.size(), 2);
+    const auto* sp = find_by_uri(reloaded.pt_data->stop_points, "stop1");
+    BOOST_REQUIRE(sp);
+    BOOST_REQUIRE_EQUAL(sp->admin_list.size(), 1);
+    BOOST_CHECK_EQUAL(sp->admin_list[0], current.geo_ref->admins[0]);
+
+    // the street network has changed, a new geo_ref is loaded
+    const std::string buf3 = save_with_vjs(2, 2);
+    Data reloaded2;
+    reloaded2.load_sectioned(buf3.data(), buf3.size(), &reloaded);
+    BOOST_CHECK_NE(reloaded2.geo_ref, reloaded.geo_ref);
+    BOOST_CHECK_EQUAL(reloaded2.geo_ref->admins.size(), 2);
+}
@@ -0,0 +1,110 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE tracing_test
+
+#include "type/tracing.h"
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace tracing = navitia::tracing;
+
+static size_t count(const std::string& str, const std::string& pattern) {
+    size_t res = 0;
+    for (auto pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + 1)) { ++res; }
+    return res;
+}
+
+static std::string dump() {
+    std::ostringstream os;
+    tracing::write_chrome_trace(os);
+    return os.str();
+}
+
+BOOST_AUTO_TEST_CASE(disabled_by_default_test) {
+    tracing::clear();
+    {
+        tracing::Span span("not_traced");
+    }
+    BOOST_CHECK_EQUAL(count(dump(), "\"name\""), 0);
+}
+
+BOOST_AUTO_TEST_CASE(spans_in_scope_test) {
+    tracing::clear();
+    {
+        tracing::Scope scope(true);
+        tracing::Span outer("outer");
+        tracing::Span inner("inner \"quoted\"");
+    }
+    {
+        tracing::Scope scope(false);
+        tracing::Span span("not_traced");
+    }
+    // the spans of the other threads are dumped too
+    std::thread([]() {
+        tracing::Scope scope(true);
+        tracing::Span span("other_thread");
+    }).join();
+
+    const auto json = dump();
+    BOOST_CHECK_EQUAL(count(json, "\"name\""), 3);
+    BOOST_CHECK_EQUAL(count(json, "\"name\":\"outer\",\"ph\":\"X\""), 1);
+    BOOST_CHECK_EQUAL(count(json, "\"name\":\"inner \\\"quoted\\\"\""), 1);
+    BOOST_CHECK_EQUAL(count(json, "other_thread"), 1);
+    BOOST_CHECK_EQUAL(count(json, "not_traced"), 0);
+    BOOST_CHECK_EQUAL(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ring_buffer_test) {
+    tracing::clear();
+    tracing::Scope scope(true);
+    { tracing::Span span("first"); }
+    for (size_t i = 0; i < tracing::nb_kept_spans; ++i) {
+        tracing::Span span("next");
+    }
+    const auto json = dump();
+    // the oldest span is dropped
+    BOOST_CHECK_EQUAL(count(json, "\"name\""), tracing::nb_kept_spans);
+    BOOST_CHECK_EQUAL(count(json, "first"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(sampler_test) {
+    tracing::Sampler never(0);
+    tracing::Sampler one_out_of_3(3);
+    size_t nb_sampled = 0;
+    for (int i = 0; i < 9; ++i) {
+        BOOST_CHECK(! never.sample());
+        if (one_out_of_3.sample()) { ++nb_sampled; }
+    }
+    BOOST_CHECK_EQUAL(nb_sampled, 3);
+}
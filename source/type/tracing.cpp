@@ -0,0 +1,157 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#include "tracing.h"
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace navitia { namespace tracing {
+
+namespace {
+
+struct Event {
+    const char* name;
+    uint64_t begin_us;
+    uint64_t end_us;
+};
+
+// the ring buffer of a thread, its mutex is only contended while dumping
+struct ThreadBuffer {
+    std::mutex mutex;
+    std::vector<Event> events;
+    size_t next = 0;
+    size_t tid;
+
+    explicit ThreadBuffer(size_t tid): tid(tid) {}
+
+    template<typename F> void for_each(F f) const {
+        // the oldest first
+        const size_t begin = events.size() < nb_kept_spans ? 0 : next;
+        for (size_t i = 0; i < events.size(); ++i) {
+            f(events[(begin + i) % events.size()]);
+        }
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+Registry& registry() {
+    static Registry registry;
+    return registry;
+}
+
+ThreadBuffer& thread_buffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (! buffer) {
+        auto& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        buffer = std::make_shared<ThreadBuffer>(reg.buffers.size() + 1);
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void write_json_string(std::ostream& os, const char* str) {
+    os << '"';
+    for (; *str; ++str) {
+        if (*str == '"' || *str == '\\') { os << '\\'; }
+        if (static_cast<unsigned char>(*str) >= 0x20) { os << *str; }
+    }
+    os << '"';
+}
+
+} // anonymous namespace
+
+namespace detail {
+
+thread_local bool enabled = false;
+
+uint64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void record(const char* name, uint64_t begin_us, uint64_t end_us) {
+    auto& buffer = thread_buffer();
+    std::lock_guard<std::mutex> lock(buffer.mutex);
+    if (buffer.events.size() < nb_kept_spans) {
+        buffer.events.push_back({name, begin_us, end_us});
+    } else {
+        buffer.events[buffer.next] = {name, begin_us, end_us};
+    }
+    buffer.next = (buffer.next + 1) % nb_kept_spans;
+}
+
+} // namespace detail
+
+Scope::Scope(bool enabled): previous(detail::enabled) {
+    detail::enabled = enabled;
+}
+
+Scope::~Scope() {
+    detail::enabled = previous;
+}
+
+void write_chrome_trace(std::ostream& os) {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& buffer: reg.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->for_each([&](const Event& event) {
+            if (! first) { os << ","; }
+            first = false;
+            os << "\n{\"name\":";
+            write_json_string(os, event.name);
+            os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+               << ",\"ts\":" << event.begin_us << ",\"dur\":" << event.end_us - event.begin_us << "}";
+        });
+    }
+    os << "\n]}\n";
+}
+
+void clear() {
+    auto& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (const auto& buffer: reg.buffers) {
+        std::lock_guard<std::mutex> buffer_lock(buffer->mutex);
+        buffer->events.clear();
+        buffer->next = 0;
+    }
+}
+
+}} // namespace navitia::tracing
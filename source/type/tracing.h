@@ -0,0 +1,99 @@
+/* Copyright © 2001-2014, Canal TP and/or its affiliates. All rights reserved.
+  
+This file is part of Navitia,
+    the software to build cool stuff with public transport.
+ 
+Hope you'll enjoy and contribute to this project,
+    powered by Canal TP (www.canaltp.fr).
+Help us simplify mobility and open public transport:
+    a non ending quest to the responsive locomotion way of traveling!
+  
+LICENCE: This program is free software; you can redistribute it and/or modify
+it under the terms of the GNU Affero General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+   
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+GNU Affero General Public License for more details.
+   
+You should have received a copy of the GNU Affero General Public License
+along with this program. If not, see <http://www.gnu.org/licenses/>.
+  
+Stay tuned using
+twitter @navitia 
+IRC #navitia on freenode
+https://groups.google.com/d/forum/navitia
+www.navitia.io
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace navitia { namespace tracing {
+
+namespace detail {
+extern thread_local bool enabled;
+uint64_t now_us();
+void record(const char* name, uint64_t begin_us, uint64_t end_us);
+}
+
+/**
+ * A span of the trace, from its construction to its destruction
+ *
+ * The name must live as long as the program, it is usually a literal.
+ * When the tracing of the thread is disabled, a span costs the test of
+ * a thread local boolean.
+ */
+class Span {
+    const char* name;
+    bool traced;
+    uint64_t begin_us = 0;
+public:
+    explicit Span(const char* name): name(name), traced(detail::enabled) {
+        if (traced) { begin_us = detail::now_us(); }
+    }
+    ~Span() {
+        if (traced) { detail::record(name, begin_us, detail::now_us()); }
+    }
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+};
+
+/// enable, or not, the spans of the thread during the scope, a request usually
+class Scope {
+    bool previous;
+public:
+    explicit Scope(bool enabled);
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+/// pick one request out of rate, none if rate is 0
+class Sampler {
+    size_t rate;
+    size_t nb_seen = 0;
+public:
+    explicit Sampler(size_t rate): rate(rate) {}
+    bool sample() { return rate != 0 && nb_seen++ % rate == 0; }
+};
+
+/// each thread keeps its last spans
+static const size_t nb_kept_spans = 16 * 1024;
+
+/**
+ * Write the kept spans of all the threads in the chrome trace event format
+ *
+ * The result can be loaded in chrome://tracing or https://ui.perfetto.dev
+ */
+void write_chrome_trace(std::ostream& os);
+
+/// forget the kept spans
+void clear();
+
+}} // namespace navitia::tracing
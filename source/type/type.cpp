@@ -160,10 +160,33 @@ StopTime StopTime::clone() const{
     ret.properties = properties;
     ret.local_traffic_zone = local_traffic_zone;
     ret.vehicle_journey = nullptr;
-    ret.shape_from_prev = shape_from_prev;
     return ret;
 }
 
+static bool order_less(const std::pair<uint16_t, boost::shared_ptr<LineString>>& shape, uint16_t order) {
+    return shape.first < order;
+}
+
+const boost::shared_ptr<LineString>& VehicleJourney::get_shape_from_prev(uint16_t order) const {
+    static const boost::shared_ptr<LineString> no_shape;
+    const auto it = std::lower_bound(shapes_from_prev.begin(), shapes_from_prev.end(), order, order_less);
+    if (it == shapes_from_prev.end() || it->first != order) { return no_shape; }
+    return it->second;
+}
+
+void VehicleJourney::set_shape_from_prev(uint16_t order, boost::shared_ptr<LineString> shape) {
+    auto it = std::lower_bound(shapes_from_prev.begin(), shapes_from_prev.end(), order, order_less);
+    if (it != shapes_from_prev.end() && it->first == order) {
+        if (shape) {
+            it->second = std::move(shape);
+        } else {
+            shapes_from_prev.erase(it);
+        }
+    } else if (shape) {
+        shapes_from_prev.emplace(it, order, std::move(shape));
+    }
+}
+
 bool StopTime::is_valid_day(u_int32_t day, const bool is_arrival, const RTLevel rt_level) const {
     if((is_arrival && arrival_time >= DateTimeUtils::SECONDS_PER_DAY)
        || (!is_arrival && departure_time >= DateTimeUtils::SECONDS_PER_DAY)) {
@@ -40,6 +40,7 @@ www.navitia.io
 #include "utils/flat_enum_map.h"
 #include "utils/exception.h"
 #include "utils/functions.h"
+#include "type/serialization_cross_ref.h"
 #include <boost/date_time/gregorian/gregorian.hpp>
 #include <vector>
 
@@ -48,6 +49,7 @@ www.navitia.io
 #include <boost/serialization/serialization.hpp>
 #include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/bitset.hpp>
+#include <boost/serialization/utility.hpp>
 #include "utils/serialization_vector.h"
 #include <boost/serialization/export.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -160,8 +162,9 @@ struct StopPoint : public Header, Nameable, hasProperties, HasMessages {
         // during serialization and deserialization.
         //
         // stop_point_connection_list is managed by StopPointConnection
-        ar & uri & label & name & stop_area & coord & fare_zone & is_zonal & idx & platform_code
-            & admin_list & _properties & impacts & dataset_list;
+        ar & uri & label & name & stop_area & coord & fare_zone & is_zonal & idx & platform_code;
+        serialize_cross_ref(ar, admin_list);
+        ar & _properties & impacts & dataset_list;
     }
 
     StopPoint(): fare_zone(0),  stop_area(nullptr), network(nullptr) {}
@@ -254,8 +257,9 @@ struct StopArea : public Header, Nameable, hasProperties, HasMessages {
     std::string timezone;
 
     template<class Archive> void serialize(Archive & ar, const unsigned int ) {
-        ar & idx & label & uri & name & coord & stop_point_list & admin_list
-            & _properties & wheelchair_boarding & impacts & visible
+        ar & idx & label & uri & name & coord & stop_point_list;
+        serialize_cross_ref(ar, admin_list);
+        ar & _properties & wheelchair_boarding & impacts & visible
             & timezone;
     }
 
@@ -491,6 +495,13 @@ struct VehicleJourney: public Header, Nameable, hasVehicleProperties {
     Company* company = nullptr;
     std::vector<StopTime> stop_time_list;
 
+    // shapes between the stop times, by order of the stop time they
+    // arrive to, sorted by order.  Most of the stop times have no
+    // shape, thus they are not stored in StopTime.
+    std::vector<std::pair<uint16_t, boost::shared_ptr<LineString>>> shapes_from_prev;
+    const boost::shared_ptr<LineString>& get_shape_from_prev(uint16_t order) const;
+    void set_shape_from_prev(uint16_t order, boost::shared_ptr<LineString> shape);
+
     // These variables are used in the case of an extension of service
     // They indicate what's the vj you can take directly after or before this one
     // They have the same block id
@@ -581,7 +592,7 @@ struct VehicleJourney: public Header, Nameable, hasVehicleProperties {
 
     template<class Archive> void save(Archive& ar, const unsigned int ) const {
         ar & name & uri & route & physical_mode & company & validity_patterns
-            & idx & stop_time_list & realtime_level
+            & idx & stop_time_list & shapes_from_prev & realtime_level
             & vehicle_journey_type
             & odt_message & _vehicle_properties
             & next_vj & prev_vj
@@ -589,7 +600,7 @@ struct VehicleJourney: public Header, Nameable, hasVehicleProperties {
     }
     template<class Archive> void load(Archive& ar, const unsigned int ) {
         ar & name & uri & route & physical_mode & company & validity_patterns
-            & idx & stop_time_list & realtime_level
+            & idx & stop_time_list & shapes_from_prev & realtime_level
             & vehicle_journey_type
             & odt_message & _vehicle_properties
             & next_vj & prev_vj
@@ -697,8 +708,9 @@ struct StopTime {
     static const uint8_t WHEELCHAIR_BOARDING = 4;
     static const uint8_t DATE_TIME_ESTIMATED = 5;
 
-    std::bitset<8> properties;
-    uint16_t local_traffic_zone = std::numeric_limits<uint16_t>::max();
+    // There is a lot of stop times, thus the members are ordered to
+    // avoid padding, and the rare shapes are stored by the vj (see
+    // shape_from_prev).
 
     /// for non frequency vj departure/arrival are the real departure/arrival
     /// for frequency vj they are relatives to the stoptime's vj's start_time
@@ -707,22 +719,24 @@ struct StopTime {
 
     VehicleJourney* vehicle_journey = nullptr;
     StopPoint* stop_point = nullptr;
-    boost::shared_ptr<LineString> shape_from_prev;
+
+    uint16_t local_traffic_zone = std::numeric_limits<uint16_t>::max();
+    uint8_t properties = 0; ///< bitset of PICK_UP, DROP_OFF...
 
     StopTime() = default;
     StopTime(uint32_t arr_time, uint32_t dep_time, StopPoint* stop_point):
         arrival_time{arr_time}, departure_time{dep_time}, stop_point{stop_point}{}
-    bool pick_up_allowed() const {return properties[PICK_UP];}
-    bool drop_off_allowed() const {return properties[DROP_OFF];}
-    bool odt() const {return properties[ODT];}
-    bool is_frequency() const {return properties[IS_FREQUENCY];}
-    bool date_time_estimated() const {return properties[DATE_TIME_ESTIMATED];}
-
-    inline void set_pick_up_allowed(bool value) {properties[PICK_UP] = value;}
-    inline void set_drop_off_allowed(bool value) {properties[DROP_OFF] = value;}
-    inline void set_odt(bool value) {properties[ODT] = value;}
-    inline void set_is_frequency(bool value) {properties[IS_FREQUENCY] = value;}
-    inline void set_date_time_estimated(bool value) {properties[DATE_TIME_ESTIMATED] = value;}
+    bool pick_up_allowed() const {return get_property(PICK_UP);}
+    bool drop_off_allowed() const {return get_property(DROP_OFF);}
+    bool odt() const {return get_property(ODT);}
+    bool is_frequency() const {return get_property(IS_FREQUENCY);}
+    bool date_time_estimated() const {return get_property(DATE_TIME_ESTIMATED);}
+
+    inline void set_pick_up_allowed(bool value) {set_property(PICK_UP, value);}
+    inline void set_drop_off_allowed(bool value) {set_property(DROP_OFF, value);}
+    inline void set_odt(bool value) {set_property(ODT, value);}
+    inline void set_is_frequency(bool value) {set_property(IS_FREQUENCY, value);}
+    inline void set_date_time_estimated(bool value) {set_property(DATE_TIME_ESTIMATED, value);}
     inline uint16_t order() const {
         static_assert(std::is_same<decltype(vehicle_journey->stop_time_list), std::vector<StopTime>>::value,
                       "vehicle_journey->stop_time_list must be a std::vector<StopTime>");
@@ -733,6 +747,13 @@ struct StopTime {
         return this - &vehicle_journey->stop_time_list.front();
     }
 
+    /// shape between the previous stop time and this one, null if none
+    const boost::shared_ptr<LineString>& shape_from_prev() const {
+        assert(vehicle_journey);
+        return vehicle_journey->get_shape_from_prev(order());
+    }
+
+    /// the shape is not cloned, as it is stored by the vj
     StopTime clone() const;
 
     /// can we start with this stop time (according to clockwise)
@@ -784,14 +805,23 @@ struct StopTime {
     bool is_valid_day(u_int32_t day, const bool is_arrival, const RTLevel rt_level) const;
 
     template<class Archive> void serialize(Archive & ar, const unsigned int ) {
-            ar & arrival_time & departure_time & vehicle_journey & stop_point & shape_from_prev
+            ar & arrival_time & departure_time & vehicle_journey & stop_point
             & properties & local_traffic_zone;
     }
 
 private:
+    bool get_property(uint8_t bit) const { return properties & (1 << bit); }
+    void set_property(uint8_t bit, bool value) {
+        if (value) {
+            properties |= (1 << bit);
+        } else {
+            properties &= ~(1 << bit);
+        }
+    }
     uint32_t f_arrival_time(const u_int32_t hour, bool clockwise = true) const;
     uint32_t f_departure_time(const u_int32_t hour, bool clockwise = false) const;
 };
+static_assert(sizeof(StopTime) <= 32, "StopTime must stay compact");
 
 struct Calendar : public Nameable, public Header {
     const static Type_e type = Type_e::Calendar;